@@ -0,0 +1,168 @@
+#include <benchmark/benchmark.h>
+
+#include <Benchmarks/MusicLib/musicLibEnvironment.hpp>
+#include <Benchmarks/MusicLib/trackGenerators.hpp>
+
+#include <MusicLib/Functions/excerptFunction.hpp>
+#include <MusicLib/Functions/fingeredChordsFunction.hpp>
+#include <MusicLib/Functions/mapChordsFunction.hpp>
+#include <MusicLib/Functions/monophonicSubtracksFunction.hpp>
+#include <MusicLib/Functions/percussionMapFunction.hpp>
+#include <MusicLib/Functions/quantizeFunction.hpp>
+#include <MusicLib/Functions/repeatFunction.hpp>
+#include <MusicLib/Functions/splitAtPitchFunction.hpp>
+#include <MusicLib/Functions/transposeFunction.hpp>
+#include <MusicLib/Percussion/builtInPercussionInstruments.hpp>
+#include <MusicLib/chord.hpp>
+
+#include <BabelWiresLib/TypeSystem/typeSystem.hpp>
+#include <BabelWiresLib/Types/Enum/enumValue.hpp>
+#include <BabelWiresLib/Types/Map/MapEntries/allToOneFallbackMapEntryData.hpp>
+#include <BabelWiresLib/Types/Map/MapEntries/oneToOneMapEntryData.hpp>
+#include <BabelWiresLib/Types/Map/mapValue.hpp>
+#include <BabelWiresLib/Types/Map/standardMapIdentifiers.hpp>
+#include <BabelWiresLib/Types/Tuple/tupleValue.hpp>
+
+namespace {
+    /// Maps C major to A minor 7th, and leaves other chords alone.
+    babelwires::MapValue getChordMap(const babelwires::TypeSystem& typeSystem) {
+        const bw_music::ChordType& chordTypeEnum = typeSystem.getEntryByType<bw_music::ChordType>();
+        const bw_music::PitchClass& pitchClassEnum =
+            typeSystem.getEntryByType<bw_music::PitchClass>().is<bw_music::PitchClass>();
+
+        babelwires::MapValue chordMap;
+        chordMap.setSourceTypeRef(bw_music::getMapChordFunctionSourceTypeRef());
+        chordMap.setTargetTypeRef(bw_music::getMapChordFunctionTargetTypeRef());
+
+        babelwires::OneToOneMapEntryData chordMaplet(typeSystem, bw_music::getMapChordFunctionSourceTypeRef(),
+                                                     bw_music::getMapChordFunctionTargetTypeRef());
+        chordMaplet.setSourceValue(babelwires::TupleValue(
+            {babelwires::EnumValue(pitchClassEnum.getIdentifierFromValue(bw_music::PitchClass::Value::C)),
+             babelwires::EnumValue(chordTypeEnum.getIdentifierFromValue(bw_music::ChordType::Value::M))}));
+        chordMaplet.setTargetValue(babelwires::TupleValue(
+            {babelwires::EnumValue(pitchClassEnum.getIdentifierFromValue(bw_music::PitchClass::Value::A)),
+             babelwires::EnumValue(chordTypeEnum.getIdentifierFromValue(bw_music::ChordType::Value::m7))}));
+        chordMap.emplaceBack(chordMaplet.clone());
+
+        babelwires::AllToOneFallbackMapEntryData fallback(typeSystem, bw_music::getMapChordFunctionTargetTypeRef());
+        babelwires::EnumValue wildcardValue(babelwires::getWildcardMatchId());
+        fallback.setTargetValue(babelwires::TupleValue({wildcardValue, wildcardValue}));
+        chordMap.emplaceBack(fallback.clone());
+        return chordMap;
+    }
+
+    /// Replaces the clap and the snare, and leaves other instruments alone.
+    babelwires::MapValue getPercussionMap(const babelwires::TypeSystem& typeSystem) {
+        const bw_music::BuiltInPercussionInstruments& builtInPercussion =
+            typeSystem.getEntryByType<bw_music::BuiltInPercussionInstruments>();
+        using Instrument = bw_music::BuiltInPercussionInstruments::Value;
+        return bw_music::getBuiltInPercussionMap(
+            typeSystem, {{builtInPercussion.getIdentifierFromValue(Instrument::Clap),
+                          builtInPercussion.getIdentifierFromValue(Instrument::Cowbll)},
+                         {builtInPercussion.getIdentifierFromValue(Instrument::AcSnr),
+                          builtInPercussion.getIdentifierFromValue(Instrument::ElSnr)}});
+    }
+
+    /// Measure the events per second at which the function consumes the given track.
+    template <typename FUNCTION>
+    void benchmarkFunction(benchmark::State& state, const bw_music::Track& track, FUNCTION function) {
+        for (auto _ : state) {
+            auto result = function(track);
+            benchmark::DoNotOptimize(result);
+        }
+        state.SetItemsProcessed(state.iterations() * track.getNumEvents());
+    }
+} // namespace
+
+static void BM_transposeTrack(benchmark::State& state) {
+    const bw_music::Track track = benchmarkUtils::makeDensePolyphony(state.range(0));
+    benchmarkFunction(state, track, [](const bw_music::Track& t) { return bw_music::transposeTrack(t, 5); });
+}
+BENCHMARK(BM_transposeTrack)->Arg(1 << 12)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+static void BM_quantize(benchmark::State& state) {
+    const bw_music::Track track = benchmarkUtils::makeDensePolyphony(state.range(0));
+    benchmarkFunction(state, track,
+                      [](const bw_music::Track& t) { return bw_music::quantize(t, babelwires::Rational(1, 16)); });
+}
+BENCHMARK(BM_quantize)->Arg(1 << 12)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+static void BM_getTrackExcerpt(benchmark::State& state) {
+    const bw_music::Track track = benchmarkUtils::makeDensePolyphony(state.range(0));
+    const bw_music::ModelDuration quarter = track.getDuration() * babelwires::Rational(1, 4);
+    benchmarkFunction(state, track, [quarter](const bw_music::Track& t) {
+        return bw_music::getTrackExcerpt(t, quarter, quarter + quarter);
+    });
+}
+BENCHMARK(BM_getTrackExcerpt)->Arg(1 << 12)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+static void BM_getMonophonicSubtracks(benchmark::State& state) {
+    const bw_music::Track track = benchmarkUtils::makeDensePolyphony(state.range(0));
+    const auto policy = static_cast<bw_music::MonophonicSubtracksPolicyEnum::Value>(state.range(1));
+    benchmarkFunction(state, track,
+                      [policy](const bw_music::Track& t) { return bw_music::getMonophonicSubtracks(t, 4, policy); });
+}
+BENCHMARK(BM_getMonophonicSubtracks)
+    ->ArgsProduct({{1 << 12, 1 << 18},
+                   {static_cast<int>(bw_music::MonophonicSubtracksPolicyEnum::Value::High),
+                    static_cast<int>(bw_music::MonophonicSubtracksPolicyEnum::Value::HighEv)}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_fingeredChords(benchmark::State& state) {
+    const bw_music::Track track = benchmarkUtils::makeBlockChords(state.range(0));
+    const auto policy = static_cast<bw_music::FingeredChordsSustainPolicyEnum::Value>(state.range(1));
+    benchmarkFunction(state, track,
+                      [policy](const bw_music::Track& t) { return bw_music::fingeredChordsFunction(t, policy); });
+}
+BENCHMARK(BM_fingeredChords)
+    ->ArgsProduct({{1 << 12, 1 << 18},
+                   {static_cast<int>(bw_music::FingeredChordsSustainPolicyEnum::Value::Notes),
+                    static_cast<int>(bw_music::FingeredChordsSustainPolicyEnum::Value::Hold)}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_mapChords(benchmark::State& state) {
+    benchmarkUtils::MusicLibEnvironment environment;
+    const babelwires::MapValue chordMap = getChordMap(environment.m_typeSystem);
+    const bw_music::Track track = benchmarkUtils::makeChordTrack(state.range(0));
+    benchmarkFunction(state, track, [&environment, &chordMap](const bw_music::Track& t) {
+        return bw_music::mapChordsFunction(environment.m_typeSystem, t, chordMap);
+    });
+}
+BENCHMARK(BM_mapChords)->Arg(1 << 12)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+/// As used by the ChordMapProcessor, which compiles the map once for all its tracks.
+static void BM_mapChordsPrecompiled(benchmark::State& state) {
+    benchmarkUtils::MusicLibEnvironment environment;
+    const bw_music::CompiledChordMap chordMap(environment.m_typeSystem, getChordMap(environment.m_typeSystem));
+    const bw_music::Track track = benchmarkUtils::makeChordTrack(state.range(0));
+    benchmarkFunction(state, track,
+                      [&chordMap](const bw_music::Track& t) { return bw_music::mapChordsFunction(chordMap, t); });
+}
+BENCHMARK(BM_mapChordsPrecompiled)->Arg(1 << 12)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+static void BM_mapPercussion(benchmark::State& state) {
+    benchmarkUtils::MusicLibEnvironment environment;
+    const babelwires::MapValue percussionMap = getPercussionMap(environment.m_typeSystem);
+    const bw_music::Track track = benchmarkUtils::makePercussionTrack(state.range(0));
+    benchmarkFunction(state, track, [&environment, &percussionMap](const bw_music::Track& t) {
+        return bw_music::mapPercussionFunction(environment.m_typeSystem, t, percussionMap);
+    });
+}
+BENCHMARK(BM_mapPercussion)->Arg(1 << 12)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+/// The items are the events of the output.
+static void BM_repeatTrack(benchmark::State& state) {
+    const bw_music::Track track = benchmarkUtils::makeMonophonicLine(state.range(0) / 4);
+    for (auto _ : state) {
+        bw_music::Track result = bw_music::repeatTrack(track, 4);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * track.getNumEvents() * 4);
+}
+BENCHMARK(BM_repeatTrack)->Arg(1 << 12)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+static void BM_splitAtPitch(benchmark::State& state) {
+    const bw_music::Track track = benchmarkUtils::makeDensePolyphony(state.range(0));
+    benchmarkFunction(state, track, [](const bw_music::Track& t) { return bw_music::splitAtPitch(60, t); });
+}
+BENCHMARK(BM_splitAtPitch)->Arg(1 << 12)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include <MusicLib/Functions/mergeFunction.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/Utilities/trackTraverser.hpp>
+
+#include <functional>
+
+namespace {
+    /// Tracks with a variety of rhythms, so their events only sometimes coincide.
+    std::vector<bw_music::Track> makeTracks(int numTracks, int numEventsPerTrack) {
+        const std::array<bw_music::ModelDuration, 4> noteLengths = {
+            babelwires::Rational(1, 4), babelwires::Rational(1, 8), babelwires::Rational(1, 3),
+            babelwires::Rational(1, 6)};
+        std::vector<bw_music::Track> tracks(numTracks);
+        for (int t = 0; t < numTracks; ++t) {
+            const bw_music::ModelDuration noteLength = noteLengths[t % noteLengths.size()];
+            for (int i = 0; i < numEventsPerTrack / 2; ++i) {
+                const bw_music::Pitch pitch = 36 + ((t + i) % 48);
+                tracks[t].addEvent(bw_music::NoteOnEvent{0, pitch});
+                tracks[t].addEvent(bw_music::NoteOffEvent{noteLength, pitch});
+            }
+        }
+        return tracks;
+    }
+
+    /// The approach used before the MergingTraverser, which queries every track at every step.
+    /// When TYPE_ERASED_VISITOR is true, the visitor is passed through a std::function, as TrackTraverser::advance
+    /// used to require.
+    template <bool TYPE_ERASED_VISITOR = false>
+    bw_music::Track mergeTracksWithTraversers(const std::vector<const bw_music::Track*>& sourceTracks) {
+        bw_music::TrackBuilder trackOut;
+
+        bw_music::ModelDuration trackDuration = 0;
+        std::vector<bw_music::TrackTraverser<bw_music::Track::const_iterator>> traversers;
+
+        const int numTracks = sourceTracks.size();
+        traversers.reserve(numTracks);
+
+        for (int i = 0; i < numTracks; ++i) {
+            const bw_music::Track& track = *sourceTracks[i];
+            traversers.emplace_back(track, track);
+            traversers.back().leastUpperBoundDuration(trackDuration);
+        }
+
+        bw_music::ModelDuration timeSinceStart = 0;
+        while (timeSinceStart < trackDuration) {
+            bw_music::ModelDuration timeToNextEvent = trackDuration - timeSinceStart;
+            for (int i = 0; i < numTracks; ++i) {
+                traversers[i].greatestLowerBoundNextEvent(timeToNextEvent);
+            }
+
+            bool isFirstEvent = true;
+            auto visitor = [&isFirstEvent, &timeToNextEvent, &trackOut](const bw_music::TrackEvent& event) {
+                bw_music::TrackEventHolder newEvent = event;
+                newEvent->setTimeSinceLastEvent(isFirstEvent ? timeToNextEvent : 0);
+                trackOut.addEvent(newEvent.release());
+                isFirstEvent = false;
+            };
+            for (int i = 0; i < numTracks; ++i) {
+                if constexpr (TYPE_ERASED_VISITOR) {
+                    traversers[i].advance(timeToNextEvent,
+                                          std::function<void(const bw_music::TrackEvent&)>(visitor));
+                } else {
+                    traversers[i].advance(timeToNextEvent, visitor);
+                }
+            }
+
+            timeSinceStart += timeToNextEvent;
+        }
+
+        trackOut.setDuration(trackDuration);
+        return trackOut.finishAndGetTrack();
+    }
+
+    template <typename MERGE_FUNCTION>
+    void benchmarkMerge(benchmark::State& state, MERGE_FUNCTION mergeFunction, int numEventsPerTrack = 1 << 14) {
+        const int numTracks = state.range(0);
+        const std::vector<bw_music::Track> tracks = makeTracks(numTracks, numEventsPerTrack);
+        std::vector<const bw_music::Track*> trackPointers;
+        for (const auto& track : tracks) {
+            trackPointers.emplace_back(&track);
+        }
+        for (auto _ : state) {
+            bw_music::Track merged = mergeFunction(trackPointers);
+            benchmark::DoNotOptimize(merged.getNumEvents());
+        }
+        state.SetItemsProcessed(state.iterations() * numTracks * numEventsPerTrack);
+    }
+} // namespace
+
+/// Merging with a heap keyed on time, as mergeTracks and the SmfWriter do.
+static void BM_mergeTracks(benchmark::State& state) {
+    benchmarkMerge(state, bw_music::mergeTracks);
+}
+BENCHMARK(BM_mergeTracks)->RangeMultiplier(2)->Range(1, 16)->Unit(benchmark::kMillisecond);
+
+/// For comparison: merging by stepping every track's TrackTraverser to the next event.
+static void BM_mergeTracksWithTraversers(benchmark::State& state) {
+    benchmarkMerge(state, mergeTracksWithTraversers<>);
+}
+BENCHMARK(BM_mergeTracksWithTraversers)->RangeMultiplier(2)->Range(1, 16)->Unit(benchmark::kMillisecond);
+
+/// The per-event cost of TrackTraverser::advance on a merge of about a million events, when the visitor can be
+/// inlined.
+static void BM_traverserAdvance(benchmark::State& state) {
+    benchmarkMerge(state, mergeTracksWithTraversers<false>, (1 << 20) / state.range(0));
+}
+BENCHMARK(BM_traverserAdvance)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+/// As above, but calling the visitor through a std::function, which is what advance used to take.
+static void BM_traverserAdvanceWithStdFunction(benchmark::State& state) {
+    benchmarkMerge(state, mergeTracksWithTraversers<true>, (1 << 20) / state.range(0));
+}
+BENCHMARK(BM_traverserAdvanceWithStdFunction)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,17 @@
+#include <benchmark/benchmark.h>
+
+#include <Common/Identifiers/identifierRegistry.hpp>
+
+int main(int argc, char** argv) {
+    // Some benchmarks use "real" types which use the BW_SHORT_ID macros, so they have to work within the same registry
+    // singleton.
+    babelwires::IdentifierRegistryScope identifierRegistry;
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,10 @@
+#include <Benchmarks/MusicLib/musicLibEnvironment.hpp>
+
+#include <MusicLib/libRegistration.hpp>
+
+#include <BabelWiresLib/libRegistration.hpp>
+
+benchmarkUtils::MusicLibEnvironment::MusicLibEnvironment() {
+    babelwires::registerLib(m_projectContext);
+    bw_music::registerLib(m_projectContext);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <BabelWiresLib/FileFormat/sourceFileFormat.hpp>
+#include <BabelWiresLib/FileFormat/targetFileFormat.hpp>
+#include <BabelWiresLib/Processors/processorFactoryRegistry.hpp>
+#include <BabelWiresLib/Project/projectContext.hpp>
+#include <BabelWiresLib/TypeSystem/typeSystem.hpp>
+
+#include <Common/Log/unifiedLog.hpp>
+#include <Common/Serialization/deserializationRegistry.hpp>
+
+namespace benchmarkUtils {
+    /// The processors and map functions need the types which MusicLib registers.
+    struct MusicLibEnvironment {
+        MusicLibEnvironment();
+
+        babelwires::UnifiedLog m_log;
+        babelwires::DeserializationRegistry m_deserializationReg;
+        babelwires::SourceFileFormatRegistry m_sourceFileFormatReg;
+        babelwires::TargetFileFormatRegistry m_targetFileFormatReg;
+        babelwires::ProcessorFactoryRegistry m_processorReg;
+        babelwires::TypeSystem m_typeSystem;
+        babelwires::ProjectContext m_projectContext{m_deserializationReg, m_sourceFileFormatReg,
+                                                    m_targetFileFormatReg, m_processorReg, m_typeSystem};
+    };
+} // namespace benchmarkUtils
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <Benchmarks/MusicLib/musicLibEnvironment.hpp>
+#include <Benchmarks/MusicLib/trackGenerators.hpp>
+
+#include <MusicLib/Processors/quantizeProcessor.hpp>
+#include <MusicLib/Processors/transposeProcessor.hpp>
+#include <MusicLib/Types/Track/trackInstance.hpp>
+#include <MusicLib/Utilities/parallelFor.hpp>
+
+#include <BabelWiresLib/ValueTree/valueTreeRoot.hpp>
+
+namespace {
+    /// Use parallelFor with at most maxThreads threads for the lifetime of this object.
+    struct ScopedExecutor {
+        ScopedExecutor(unsigned int maxThreads) {
+            bw_music::ParallelTrackProcessor::setExecutor(
+                [maxThreads](std::size_t numTasks, const std::function<void(std::size_t)>& task) {
+                    bw_music::parallelFor(numTasks, maxThreads, task);
+                });
+        }
+        ~ScopedExecutor() { bw_music::ParallelTrackProcessor::setExecutor({}); }
+    };
+
+    /// Give the processor numTracks copies of a dense track, and return the total number of events.
+    int setInputTracks(babelwires::ValueTreeNode& input, babelwires::ShortId arrayId, int numTracks,
+                       int numEventsPerTrack) {
+        babelwires::ArrayInstanceImpl<babelwires::ValueTreeNode, bw_music::TrackType> inArray(
+            input.getChildFromStep(arrayId).is<babelwires::ValueTreeNode>());
+        const bw_music::Track track = benchmarkUtils::makeDensePolyphony(numEventsPerTrack);
+        inArray.setSize(numTracks);
+        for (int i = 0; i < numTracks; ++i) {
+            inArray.getEntry(i).set(track);
+        }
+        return numTracks * track.getNumEvents();
+    }
+
+    /// Each iteration changes a parameter, so every track is reprocessed.
+    template <typename PROCESSOR, typename CHANGE_PARAMETER>
+    void benchmarkProcessor(benchmark::State& state, CHANGE_PARAMETER changeParameter) {
+        benchmarkUtils::MusicLibEnvironment environment;
+        ScopedExecutor executor(state.range(0));
+
+        PROCESSOR processor(environment.m_projectContext);
+        processor.getInput().setToDefault();
+        processor.getOutput().setToDefault();
+
+        const int numEvents =
+            setInputTracks(processor.getInput(), PROCESSOR::getCommonArrayId(), state.range(1), state.range(2));
+
+        int iteration = 0;
+        for (auto _ : state) {
+            state.PauseTiming();
+            processor.getInput().clearChanges();
+            changeParameter(processor.getInput(), iteration++);
+            state.ResumeTiming();
+            processor.process(environment.m_log);
+        }
+        state.SetItemsProcessed(state.iterations() * numEvents);
+    }
+} // namespace
+
+/// Arguments: The maximum number of threads, the number of tracks and the number of events in each.
+static void BM_transposeProcessor(benchmark::State& state) {
+    benchmarkProcessor<bw_music::TransposeProcessor>(state, [](babelwires::ValueTreeNode& input, int iteration) {
+        bw_music::TransposeProcessorInput::Instance in(input);
+        in.getOffset().set((iteration % 2) ? 5 : -5);
+    });
+}
+
+/// Arguments: The maximum number of threads, the number of tracks and the number of events in each.
+static void BM_quantizeProcessor(benchmark::State& state) {
+    benchmarkProcessor<bw_music::QuantizeProcessor>(state, [](babelwires::ValueTreeNode& input, int iteration) {
+        bw_music::QuantizeProcessorInput::Instance in(input);
+        in.getBeat().set((iteration % 2) ? babelwires::Rational(1, 16) : babelwires::Rational(1, 8));
+    });
+}
+
+// Sixteen tracks is the size of a typical General MIDI sequence.
+BENCHMARK(BM_transposeProcessor)
+    ->ArgsProduct({{1, 2, 4, 8, 16}, {16}, {1 << 15}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_quantizeProcessor)
+    ->ArgsProduct({{1, 2, 4, 8, 16}, {16}, {1 << 15}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
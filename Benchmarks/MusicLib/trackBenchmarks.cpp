@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/track.hpp>
+
+namespace {
+    void addNotes(bw_music::Track& track, int numEvents) {
+        for (int i = 0; i < numEvents / 2; ++i) {
+            const bw_music::Pitch pitch = 36 + (i % 48);
+            track.addEvent(bw_music::NoteOnEvent{0, pitch});
+            track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 8), pitch});
+        }
+    }
+} // namespace
+
+/// Building a track, as every Function does for its output.
+static void BM_buildTrack(benchmark::State& state) {
+    const int numEvents = state.range(0);
+    for (auto _ : state) {
+        bw_music::Track track;
+        addNotes(track, numEvents);
+        benchmark::DoNotOptimize(track.getHash());
+        benchmark::DoNotOptimize(track.getDuration());
+    }
+    state.SetItemsProcessed(state.iterations() * numEvents);
+}
+BENCHMARK(BM_buildTrack)->Arg(1 << 10)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+/// Building a track and then querying the summary, as the UI does.
+static void BM_buildTrackAndSummarize(benchmark::State& state) {
+    const int numEvents = state.range(0);
+    for (auto _ : state) {
+        bw_music::Track track;
+        addNotes(track, numEvents);
+        benchmark::DoNotOptimize(track.getNumEventGroupsByCategory().size());
+    }
+    state.SetItemsProcessed(state.iterations() * numEvents);
+}
+BENCHMARK(BM_buildTrackAndSummarize)->Arg(1 << 10)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
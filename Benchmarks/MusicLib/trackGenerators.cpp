@@ -0,0 +1,89 @@
+#include <Benchmarks/MusicLib/trackGenerators.hpp>
+
+#include <MusicLib/Functions/mergeFunction.hpp>
+#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
+
+#include <array>
+
+bw_music::Track benchmarkUtils::makeMonophonicLine(int numEvents, bw_music::Pitch lowestPitch) {
+    const std::array<bw_music::ModelDuration, 6> noteLengths = {
+        babelwires::Rational(1, 8),  babelwires::Rational(1, 6),  babelwires::Rational(1, 4),
+        babelwires::Rational(1, 12), babelwires::Rational(3, 16), babelwires::Rational(1, 3)};
+    bw_music::Track track;
+    bw_music::ModelDuration rest = 0;
+    for (int i = 0; i < numEvents / 2; ++i) {
+        const bw_music::Pitch pitch = lowestPitch + ((i * 7) % 24);
+        track.addEvent(bw_music::NoteOnEvent{rest, pitch, static_cast<bw_music::Velocity>(64 + (i % 64))});
+        track.addEvent(bw_music::NoteOffEvent{noteLengths[i % noteLengths.size()], pitch});
+        rest = (i % 5 == 4) ? babelwires::Rational(1, 8) : 0;
+    }
+    return track;
+}
+
+bw_music::Track benchmarkUtils::makeBlockChords(int numEvents) {
+    const std::array<std::array<bw_music::Pitch, 3>, 2> triads = {{{0, 4, 7}, {0, 3, 7}}};
+    bw_music::Track track;
+    for (int i = 0; i < numEvents / 6; ++i) {
+        const bw_music::Pitch root = 36 + ((i * 5) % 12);
+        const auto& triad = triads[i % triads.size()];
+        for (int j = 0; j < 3; ++j) {
+            track.addEvent(bw_music::NoteOnEvent{0, static_cast<bw_music::Pitch>(root + triad[j])});
+        }
+        for (int j = 0; j < 3; ++j) {
+            const bw_music::ModelDuration duration = (j == 0) ? babelwires::Rational(1, 2) : 0;
+            track.addEvent(bw_music::NoteOffEvent{duration, static_cast<bw_music::Pitch>(root + triad[j])});
+        }
+    }
+    return track;
+}
+
+bw_music::Track benchmarkUtils::makeDensePolyphony(int numEvents) {
+    // The parts use disjoint pitch ranges, so no two notes of the same pitch overlap.
+    const bw_music::Track chords = makeBlockChords(numEvents / 4);
+    const bw_music::Track line0 = makeMonophonicLine(numEvents / 4, 55);
+    const bw_music::Track line1 = makeMonophonicLine(numEvents / 4, 79);
+    const bw_music::Track line2 = makeMonophonicLine(numEvents / 4, 103);
+    return bw_music::mergeTracks({&chords, &line0, &line1, &line2});
+}
+
+bw_music::Track benchmarkUtils::makeChordTrack(int numEvents) {
+    const std::array<bw_music::ChordType::Value, 5> chordTypes = {
+        bw_music::ChordType::Value::M, bw_music::ChordType::Value::m, bw_music::ChordType::Value::M7,
+        bw_music::ChordType::Value::m7, bw_music::ChordType::Value::M6};
+    bw_music::Track track;
+    for (int i = 0; i < numEvents / 2; ++i) {
+        const bw_music::ModelDuration gap = (i % 7 == 6) ? babelwires::Rational(1, 4) : 0;
+        const bw_music::Chord chord{static_cast<bw_music::PitchClass::Value>((i * 7) % 12),
+                                    chordTypes[i % chordTypes.size()]};
+        track.addEvent(bw_music::ChordOnEvent{gap, chord});
+        track.addEvent(bw_music::ChordOffEvent{(i % 2) ? babelwires::Rational(1, 4) : babelwires::Rational(1, 2)});
+    }
+    return track;
+}
+
+bw_music::Track benchmarkUtils::makePercussionTrack(int numEvents) {
+    bw_music::Track track;
+    bw_music::ModelDuration timeToNextStep = 0;
+    for (int step = 0; track.getNumEvents() < numEvents; ++step) {
+        const char* accompaniment = nullptr;
+        if (step % 4 == 0) {
+            accompaniment = "AcBass";
+        } else if (step % 8 == 6) {
+            accompaniment = "Clap";
+        } else if (step % 4 == 2) {
+            accompaniment = "AcSnr";
+        }
+        track.addEvent(bw_music::PercussionOnEvent{timeToNextStep, "ClHHat", 100});
+        if (accompaniment) {
+            track.addEvent(bw_music::PercussionOnEvent{0, accompaniment, 120});
+        }
+        track.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 16), "ClHHat"});
+        if (accompaniment) {
+            track.addEvent(bw_music::PercussionOffEvent{0, accompaniment});
+        }
+        timeToNextStep = babelwires::Rational(1, 16);
+    }
+    return track;
+}
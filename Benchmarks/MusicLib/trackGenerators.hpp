@@ -0,0 +1,23 @@
+#pragma once
+
+#include <MusicLib/Types/Track/track.hpp>
+
+namespace benchmarkUtils {
+    /// Each generator returns a track of approximately numEvents events. The content is deterministic, so results
+    /// are comparable between runs.
+
+    /// A single line of notes with varied lengths, including triplets and occasional rests.
+    bw_music::Track makeMonophonicLine(int numEvents, bw_music::Pitch lowestPitch = 48);
+
+    /// Root position triads played as notes, which fingeredChordsFunction recognizes.
+    bw_music::Track makeBlockChords(int numEvents);
+
+    /// Block chords in the bass under three overlapping melodic lines.
+    bw_music::Track makeDensePolyphony(int numEvents);
+
+    /// Chord events with a variety of roots and chord types, separated by occasional gaps.
+    bw_music::Track makeChordTrack(int numEvents);
+
+    /// A drum pattern of hi-hats over bass drum, snare and clap, using built-in percussion instruments.
+    bw_music::Track makePercussionTrack(int numEvents);
+} // namespace benchmarkUtils
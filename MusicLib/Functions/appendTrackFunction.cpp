@@ -8,25 +8,45 @@
 #include <MusicLib/Functions/appendTrackFunction.hpp>
 
 #include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 
 #include <BabelWiresLib/ValueTree/modelExceptions.hpp>
 
-void bw_music::appendTrack(Track& targetTrack, const Track& sourceTrack) {
-    assert((&targetTrack != &sourceTrack) && "You cannot have source and target track being the same");
+namespace {
+    void addUnchangedEvent(bw_music::Track& targetTrack, const bw_music::Track::const_iterator& it) {
+        targetTrack.addEvent(*it);
+    }
 
-    const ModelDuration initialDuration = targetTrack.getDuration();
-    const ModelDuration gapAtEnd = targetTrack.getDuration() - targetTrack.getTotalEventDuration();
+    void addUnchangedEvent(bw_music::TrackBuilder& targetTrack, const bw_music::Track::const_iterator& it) {
+        targetTrack.passThroughEvent(it);
+    }
 
-    auto it = sourceTrack.begin();
-    if (it != sourceTrack.end()) {
-        TrackEventHolder firstEventInSequence = *it;
-        firstEventInSequence->setTimeSinceLastEvent(firstEventInSequence->getTimeSinceLastEvent() + gapAtEnd);
-        targetTrack.addEvent(firstEventInSequence.release());
+    template <typename TARGET_TRACK> void appendTrackImpl(TARGET_TRACK& targetTrack, const bw_music::Track& sourceTrack) {
+        const bw_music::ModelDuration initialDuration = targetTrack.getDuration();
+        const bw_music::ModelDuration gapAtEnd = targetTrack.getDuration() - targetTrack.getTotalEventDuration();
 
-        for (++it; it != sourceTrack.end(); ++it) {
-            targetTrack.addEvent(*it);
+        auto it = sourceTrack.begin();
+        if (it != sourceTrack.end()) {
+            if (gapAtEnd > 0) {
+                bw_music::TrackEventHolder firstEventInSequence = *it;
+                firstEventInSequence->setTimeSinceLastEvent(firstEventInSequence->getTimeSinceLastEvent() + gapAtEnd);
+                targetTrack.addEvent(firstEventInSequence.release());
+                ++it;
+            }
+            for (; it != sourceTrack.end(); ++it) {
+                addUnchangedEvent(targetTrack, it);
+            }
         }
+
+        targetTrack.setDuration(initialDuration + sourceTrack.getDuration());
     }
-    
-    targetTrack.setDuration(initialDuration + sourceTrack.getDuration());
+} // namespace
+
+void bw_music::appendTrack(Track& targetTrack, const Track& sourceTrack) {
+    assert((&targetTrack != &sourceTrack) && "You cannot have source and target track being the same");
+    appendTrackImpl(targetTrack, sourceTrack);
+}
+
+void bw_music::appendTrack(TrackBuilder& targetTrack, const Track& sourceTrack) {
+    appendTrackImpl(targetTrack, sourceTrack);
 }
@@ -10,6 +10,11 @@
 #include <MusicLib/Types/Track/track.hpp>
 
 namespace bw_music {
+    class TrackBuilder;
+
     /// Add the events of sourceTrack to the end of targetTrack.
     void appendTrack(Track& targetTrack, const Track& sourceTrack);
+
+    /// Add the events of sourceTrack to the end of the track being built.
+    void appendTrack(TrackBuilder& targetTrack, const Track& sourceTrack);
 } // namespace bw_music
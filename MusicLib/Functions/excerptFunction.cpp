@@ -8,41 +8,52 @@
 #include <MusicLib/Functions/excerptFunction.hpp>
 
 #include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 
 #include <set>
 
 bw_music::Track bw_music::getTrackExcerpt(const Track& trackIn, ModelDuration start,
                                                            ModelDuration duration) {
-    Track trackOut;
+    TrackBuilder trackOut;
 
-    ModelDuration end = start + duration;
-    ModelDuration timeProcessed;
-    ModelDuration timeOfCurrentEvent;
+    // Work in integer ticks.
+    Timebase timebase = trackIn.getTimebase();
+    timebase.extendToRepresent(start);
+    timebase.extendToRepresent(duration);
+    const Ticks startTicks = timebase.toTicks(start);
+    const Ticks endTicks = startTicks + timebase.toTicks(duration);
 
-    auto it = trackIn.begin();
+    using Group = Track::Group;
 
-    using Group = std::tuple<TrackEvent::GroupingInfo::Category, TrackEvent::GroupingInfo::GroupValue>;
-
-    std::set<Group> groupsOpenAtStart;
+    // Avoid visiting most of the events before start.
+    Track::SeekPosition seekPosition = trackIn.getSeekPositionBefore(start);
+    auto it = seekPosition.m_iterator;
+    Ticks timeProcessed = timebase.toTicks(seekPosition.m_timeBeforeEvent);
+    std::set<Group> groupsOpenAtStart = std::move(seekPosition.m_openGroups);
     std::set<Group> groupsOpenAtEnd;
 
-    while ((it != trackIn.end()) && ((timeProcessed + it->getTimeSinceLastEvent()) < start)) {
+    auto getTimeOfEvent = [&timebase, &timeProcessed, &it]() {
+        return timeProcessed + timebase.toTicks(it->getTimeSinceLastEvent());
+    };
+
+    while ((it != trackIn.end()) && (getTimeOfEvent() < startTicks)) {
         const TrackEvent::GroupingInfo info = it->getGroupingInfo();
         if (info.m_grouping == TrackEvent::GroupingInfo::Grouping::StartOfGroup) {
             groupsOpenAtStart.insert(std::make_tuple(info.m_category, info.m_groupValue));
         } else if (info.m_grouping == TrackEvent::GroupingInfo::Grouping::EndOfGroup) {
             groupsOpenAtStart.erase(std::make_tuple(info.m_category, info.m_groupValue));
         }
-        timeProcessed += it->getTimeSinceLastEvent();
+        timeProcessed = getTimeOfEvent();
         ++it;
     }
 
     bool isFirstEvent = true;
-    while ((it != trackIn.end()) && ((timeProcessed + it->getTimeSinceLastEvent()) <= end)) {
+    while ((it != trackIn.end()) && (getTimeOfEvent() <= endTicks)) {
+        const Ticks timeOfEvent = getTimeOfEvent();
         bool skip = false;
         const TrackEvent::GroupingInfo info = it->getGroupingInfo();
         if (info.m_grouping == TrackEvent::GroupingInfo::Grouping::StartOfGroup) {
-            if ((timeProcessed + it->getTimeSinceLastEvent()) != end) {
+            if (timeOfEvent != endTicks) {
                 groupsOpenAtEnd.insert(std::make_tuple(info.m_category, info.m_groupValue));
             }
             else {
@@ -65,14 +76,16 @@ bw_music::Track bw_music::getTrackExcerpt(const Track& trackIn, ModelDuration st
         }
 
         if (!skip) {
-            TrackEventHolder newEvent = *it;
             if (isFirstEvent) {
-                newEvent->setTimeSinceLastEvent(newEvent->getTimeSinceLastEvent() + timeProcessed - start);
+                TrackEventHolder newEvent = *it;
+                newEvent->setTimeSinceLastEvent(timebase.toModelDuration(timeOfEvent - startTicks));
+                trackOut.addEvent(newEvent.release());
                 isFirstEvent = false;
+            } else {
+                trackOut.passThroughEvent(it);
             }
-            trackOut.addEvent(newEvent.release());
         }
-        timeProcessed += it->getTimeSinceLastEvent();
+        timeProcessed = timeOfEvent;
         ++it;
     }
 
@@ -87,7 +100,7 @@ bw_music::Track bw_music::getTrackExcerpt(const Track& trackIn, ModelDuration st
 
                 TrackEventHolder newEvent = *it;
                 if (isFirstEvent) {
-                    newEvent->setTimeSinceLastEvent(end - timeProcessed);
+                    newEvent->setTimeSinceLastEvent(timebase.toModelDuration(endTicks - timeProcessed));
                     isFirstEvent = false;
                 } else {
                     newEvent->setTimeSinceLastEvent(0);
@@ -98,5 +111,5 @@ bw_music::Track bw_music::getTrackExcerpt(const Track& trackIn, ModelDuration st
         ++it;
     }
     trackOut.setDuration(duration);
-    return trackOut;
+    return trackOut.finishAndGetTrack();
 }
@@ -8,6 +8,7 @@
 #include <MusicLib/Functions/fingeredChordsFunction.hpp>
 
 #include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 #include <MusicLib/Utilities/filteredTrackIterator.hpp>
 
 #include <algorithm>
@@ -198,7 +199,7 @@ bw_music::Track bw_music::fingeredChordsFunction(const Track& sourceTrack, Finge
     // Required for getMatchingChordType::ValueFromIntervals
     assert(std::is_sorted(recognizedIntervals.begin(), recognizedIntervals.end()));
 
-    bw_music::Track trackOut;
+    bw_music::TrackBuilder trackOut;
 
     ActivePitches activePitches;
     bw_music::ModelDuration timeSinceLastChordEvent = 0;
@@ -237,5 +238,5 @@ bw_music::Track bw_music::fingeredChordsFunction(const Track& sourceTrack, Finge
         trackOut.addEvent(ChordOffEvent(timeSinceLastChordEvent));
     }
     trackOut.setDuration(sourceTrack.getDuration());
-    return trackOut;
+    return trackOut.finishAndGetTrack();
 }
@@ -9,6 +9,7 @@
 
 #include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
 #include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 #include <MusicLib/chord.hpp>
 #include <MusicLib/pitch.hpp>
 
@@ -96,6 +97,7 @@ namespace {
 
     /// As yet, there is no generic handling of wildcards when they occur within tuples, as in this case.
     /// Therefore, I cannot use one of the preexisting applicators.
+    /// This searches the map entries, so it is only used to compile a CompiledChordMap.
     /// TODO: Can this be made generic?
     class ChordMapApplicator {
       public:
@@ -135,56 +137,46 @@ namespace {
             return {};
         };
 
-        std::optional<bw_music::Chord> operator[](const bw_music::Chord& chord) {
-            const std::uint16_t code = chordToCode(chord);
-            const auto [it, wasInserted] = m_memo.try_emplace(code, -2);
-            std::uint16_t& newCode = it->second;
-            if (wasInserted) {
-                unsigned int matchingEntry = 0;
-                while (matchingEntry < m_mapValue.getNumMapEntries() - 1) {
-                    const babelwires::MapEntryData& entry = m_mapValue.getMapEntry(matchingEntry);
-                    if (const babelwires::TupleValue* sourceTuple =
-                            entry.getSourceValue()->as<babelwires::TupleValue>()) {
-                        const unsigned int pitchClassIndex =
-                            m_sourcePitchClassAdapter(sourceTuple->getValue(0)->is<babelwires::EnumValue>());
-                        const unsigned int chordTypeIndex =
-                            m_sourceChordTypeAdapter(sourceTuple->getValue(1)->is<babelwires::EnumValue>());
-                        if (((static_cast<unsigned int>(chord.m_root) + 1 == pitchClassIndex) ||
-                             (pitchClassIndex == 0)) &&
-                            ((static_cast<unsigned int>(chord.m_chordType) + 1 == chordTypeIndex) ||
-                             (chordTypeIndex == 0))) {
-                            // Found match.
-                            break;
-                        }
+        /// Find the target of the chord by searching the map entries.
+        std::optional<bw_music::Chord> getTarget(const bw_music::Chord& chord) {
+            unsigned int matchingEntry = 0;
+            while (matchingEntry < m_mapValue.getNumMapEntries() - 1) {
+                const babelwires::MapEntryData& entry = m_mapValue.getMapEntry(matchingEntry);
+                if (const babelwires::TupleValue* sourceTuple = entry.getSourceValue()->as<babelwires::TupleValue>()) {
+                    const unsigned int pitchClassIndex =
+                        m_sourcePitchClassAdapter(sourceTuple->getValue(0)->is<babelwires::EnumValue>());
+                    const unsigned int chordTypeIndex =
+                        m_sourceChordTypeAdapter(sourceTuple->getValue(1)->is<babelwires::EnumValue>());
+                    if (((static_cast<unsigned int>(chord.m_root) + 1 == pitchClassIndex) || (pitchClassIndex == 0)) &&
+                        ((static_cast<unsigned int>(chord.m_chordType) + 1 == chordTypeIndex) ||
+                         (chordTypeIndex == 0))) {
+                        // Found match.
+                        break;
                     }
-                    ++matchingEntry;
                 }
-                const babelwires::MapEntryData& entry = m_mapValue.getMapEntry(matchingEntry);
-                if (entry.getTargetValue()->as<babelwires::EnumValue>()) {
-                    assert(entry.getTargetValue()->as<babelwires::EnumValue>()->get() ==
-                               bw_music::NoChord::getNoChordValue() &&
-                           "Bare EnumValue in ChordMap target that wasn't the NoChord value");
-                    newCode = -1;
-                } else {
-                    const babelwires::TupleValue& target = entry.getTargetValue()->is<babelwires::TupleValue>();
-                    unsigned int targetPitchClassIndex =
-                        m_targetPitchClassAdapter(target.getValue(0)->is<babelwires::EnumValue>());
-                    bw_music::PitchClass::Value newPitchClass =
-                        (targetPitchClassIndex == 0)
-                            ? chord.m_root
-                            : static_cast<bw_music::PitchClass::Value>(targetPitchClassIndex - 1);
+                ++matchingEntry;
+            }
+            const babelwires::MapEntryData& entry = m_mapValue.getMapEntry(matchingEntry);
+            if (entry.getTargetValue()->as<babelwires::EnumValue>()) {
+                assert(entry.getTargetValue()->as<babelwires::EnumValue>()->get() ==
+                           bw_music::NoChord::getNoChordValue() &&
+                       "Bare EnumValue in ChordMap target that wasn't the NoChord value");
+                return {};
+            }
+            const babelwires::TupleValue& target = entry.getTargetValue()->is<babelwires::TupleValue>();
+            unsigned int targetPitchClassIndex =
+                m_targetPitchClassAdapter(target.getValue(0)->is<babelwires::EnumValue>());
+            bw_music::PitchClass::Value newPitchClass =
+                (targetPitchClassIndex == 0) ? chord.m_root
+                                             : static_cast<bw_music::PitchClass::Value>(targetPitchClassIndex - 1);
 
-                    unsigned int targetChordTypeIndex =
-                        m_targetChordTypeAdapter(target.getValue(1)->is<babelwires::EnumValue>());
-                    bw_music::ChordType::Value newChordType =
-                        (targetChordTypeIndex == 0) ? chord.m_chordType
-                                                    : static_cast<bw_music::ChordType::Value>(targetChordTypeIndex - 1);
+            unsigned int targetChordTypeIndex =
+                m_targetChordTypeAdapter(target.getValue(1)->is<babelwires::EnumValue>());
+            bw_music::ChordType::Value newChordType =
+                (targetChordTypeIndex == 0) ? chord.m_chordType
+                                            : static_cast<bw_music::ChordType::Value>(targetChordTypeIndex - 1);
 
-                    newCode = chordToCode(bw_music::Chord(newPitchClass, newChordType));
-                }
-            }
-            assert((newCode != -2) && "Entry not inserted");
-            return codeToChord(newCode);
+            return bw_music::Chord{newPitchClass, newChordType};
         }
 
       private:
@@ -198,21 +190,7 @@ namespace {
             , m_targetPitchClassAdapter(std::get<0>(targetTupleComponentTypes))
             , m_targetChordTypeAdapter(std::get<1>(targetTupleComponentTypes)) {}
 
-        std::uint16_t chordToCode(const bw_music::Chord& chord) const {
-            return (static_cast<std::uint8_t>(chord.m_root) << 8) | static_cast<std::uint8_t>(chord.m_chordType);
-        }
-
-        std::optional<bw_music::Chord> codeToChord(std::uint16_t code) const {
-            if (code != static_cast<std::uint16_t>(-1)) {
-                return bw_music::Chord{static_cast<bw_music::PitchClass::Value>(code >> 8),
-                                       static_cast<bw_music::ChordType::Value>(code & 255)};
-            } else {
-                return {};
-            }
-        }
-
       private:
-        std::unordered_map<std::uint16_t, std::uint16_t> m_memo;
         const babelwires::MapValue& m_mapValue;
         babelwires::EnumToIndexValueAdapter m_sourcePitchClassAdapter;
         babelwires::EnumToIndexValueAdapter m_sourceChordTypeAdapter;
@@ -221,18 +199,44 @@ namespace {
     };
 } // namespace
 
-bw_music::Track bw_music::mapChordsFunction(const babelwires::TypeSystem& typeSystem, const Track& sourceTrack,
-                                            const babelwires::MapValue& chordMapValue) {
+bw_music::CompiledChordMap::CompiledChordMap(const babelwires::TypeSystem& typeSystem,
+                                             const babelwires::MapValue& chordMapValue) {
     if (!chordMapValue.isValid(typeSystem)) {
         throw babelwires::ModelException() << "The Chord Type Map is not valid.";
     }
+    static_assert(s_numPitchClasses * s_numChordTypes < s_noChordCode);
 
     ChordMapApplicator mapApplicator(typeSystem, chordMapValue);
+    m_noChordTarget = mapApplicator.getNoChordTarget();
+    for (unsigned int root = 0; root < s_numPitchClasses; ++root) {
+        for (unsigned int chordType = 0; chordType < s_numChordTypes; ++chordType) {
+            const Chord chord{static_cast<PitchClass::Value>(root), static_cast<ChordType::Value>(chordType)};
+            const std::optional<Chord> target = mapApplicator.getTarget(chord);
+            m_table[getIndex(chord)] = target ? getIndex(*target) : s_noChordCode;
+        }
+    }
+}
+
+std::optional<bw_music::Chord> bw_music::CompiledChordMap::operator[](Chord chord) const {
+    assert((chord.m_chordType != ChordType::Value::NotAValue) && "Chord events must have a chord type");
+    const std::uint16_t targetIndex = m_table[getIndex(chord)];
+    if (targetIndex == s_noChordCode) {
+        return {};
+    }
+    return Chord{static_cast<PitchClass::Value>(targetIndex / s_numChordTypes),
+                 static_cast<ChordType::Value>(targetIndex % s_numChordTypes)};
+}
 
-    Track trackOut;
+bw_music::Track bw_music::mapChordsFunction(const babelwires::TypeSystem& typeSystem, const Track& sourceTrack,
+                                            const babelwires::MapValue& chordMapValue) {
+    return mapChordsFunction(CompiledChordMap(typeSystem, chordMapValue), sourceTrack);
+}
+
+bw_music::Track bw_music::mapChordsFunction(const CompiledChordMap& chordMap, const Track& sourceTrack) {
+    TrackBuilder trackOut;
     ModelDuration totalEventDuration;
 
-    std::optional<bw_music::Chord> silenceToChordChord = mapApplicator.getNoChordTarget();
+    const std::optional<bw_music::Chord>& silenceToChordChord = chordMap.getNoChordTarget();
 
     enum {
         pending,
@@ -253,18 +257,22 @@ bw_music::Track bw_music::mapChordsFunction(const babelwires::TypeSystem& typeSy
             state = silenceToChord;
         }
 
-        if (it->as<ChordOnEvent>()) {
-            TrackEventHolder holder(*it);
-            Chord& chord = holder->is<ChordOnEvent>().m_chord;
-            if (std::optional<bw_music::Chord> targetChord = mapApplicator[chord]) {
+        if (const ChordOnEvent* chordOnEvent = it->as<ChordOnEvent>()) {
+            if (std::optional<bw_music::Chord> targetChord = chordMap[chordOnEvent->m_chord]) {
                 if (state == silenceToChord) {
                     trackOut.addEvent(ChordOffEvent(timeSinceLastEvent));
                     timeSinceLastEvent = 0;
                 }
-                holder->setTimeSinceLastEvent(timeSinceLastEvent);
+                if ((*targetChord == chordOnEvent->m_chord) &&
+                    (timeSinceLastEvent == chordOnEvent->getTimeSinceLastEvent())) {
+                    trackOut.passThroughEvent(it);
+                } else {
+                    TrackEventHolder holder(*it);
+                    holder->setTimeSinceLastEvent(timeSinceLastEvent);
+                    holder->is<ChordOnEvent>().m_chord = *targetChord;
+                    trackOut.addEvent(holder.release());
+                }
                 timeSinceLastEvent = 0;
-                chord = *targetChord;
-                trackOut.addEvent(holder.release());
                 state = chordToChord;
             } else {
                 state = chordToSilence;
@@ -282,7 +290,7 @@ bw_music::Track bw_music::mapChordsFunction(const babelwires::TypeSystem& typeSy
                 timeSinceLastEvent = 0;
                 trackOut.addEvent(holder.release());
             } else {
-                trackOut.addEvent(*it);
+                trackOut.passThroughEvent(it);
                 timeSinceLastEvent = 0;
             }
         }
@@ -297,5 +305,5 @@ bw_music::Track bw_music::mapChordsFunction(const babelwires::TypeSystem& typeSy
     }
 
     trackOut.setDuration(sourceTrack.getDuration());
-    return trackOut;
+    return trackOut.finishAndGetTrack();
 }
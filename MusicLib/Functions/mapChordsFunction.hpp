@@ -5,7 +5,14 @@
  *
  * Licensed under the GPLv3.0. See LICENSE file.
  **/
+#pragma once
+
 #include <MusicLib/Types/Track/track.hpp>
+#include <MusicLib/chord.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
 
 namespace babelwires {
     class MapValue;
@@ -16,8 +23,41 @@ namespace bw_music {
     babelwires::TypeRef getMapChordFunctionSourceTypeRef();
     babelwires::TypeRef getMapChordFunctionTargetTypeRef();
 
+    /// A chord map compiled into a table with an entry for every chord.
+    /// It is immutable once constructed, so one instance can be applied to many tracks concurrently.
+    class CompiledChordMap {
+      public:
+        /// Throws a ModelException if the map is not valid.
+        CompiledChordMap(const babelwires::TypeSystem& typeSystem, const babelwires::MapValue& chordMapValue);
+
+        /// The chord to which the given chord maps, or nothing if it maps to NoChord.
+        std::optional<Chord> operator[](Chord chord) const;
+
+        /// The chord which should be active when no chord in the source track is active, if any.
+        const std::optional<Chord>& getNoChordTarget() const { return m_noChordTarget; }
+
+      private:
+        static constexpr unsigned int s_numChordTypes = static_cast<unsigned int>(ChordType::Value::NUM_VALUES);
+        static constexpr unsigned int s_numPitchClasses = static_cast<unsigned int>(PitchClass::Value::NUM_VALUES);
+        /// Marks a chord which maps to NoChord.
+        static constexpr std::uint16_t s_noChordCode = -1;
+
+        static unsigned int getIndex(Chord chord) {
+            return static_cast<unsigned int>(chord.m_root) * s_numChordTypes +
+                   static_cast<unsigned int>(chord.m_chordType);
+        }
+
+      private:
+        /// Each entry holds the index of the target chord, or s_noChordCode.
+        std::array<std::uint16_t, s_numPitchClasses * s_numChordTypes> m_table;
+        std::optional<Chord> m_noChordTarget;
+    };
+
     /// Apply maps to chord events in the track.
     /// You can specify a chord that should be active when no chord in the sourceTrack is active
     /// by having blanks in the source map.
     Track mapChordsFunction(const babelwires::TypeSystem& typeSystem, const Track& sourceTrack, const babelwires::MapValue& chordMapValue);
+
+    /// Apply a precompiled chord map to chord events in the track.
+    Track mapChordsFunction(const CompiledChordMap& chordMap, const Track& sourceTrack);
 }
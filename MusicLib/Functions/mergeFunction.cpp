@@ -8,48 +8,32 @@
 #include <MusicLib/Functions/mergeFunction.hpp>
 
 #include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
-#include <MusicLib/Utilities/trackTraverser.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/Utilities/mergingTraverser.hpp>
 
 #include <BabelWiresLib/ValueTree/modelExceptions.hpp>
 
 bw_music::Track bw_music::mergeTracks(const std::vector<const Track*>& sourceTracks) {
-    Track trackOut;
-
-    bw_music::ModelDuration trackDuration = 0;
-    std::vector<TrackTraverser<Track::const_iterator>> traversers;
-
-    const int numTracks = sourceTracks.size();
-    traversers.reserve(numTracks);
-
-    for (int i = 0; i < numTracks; ++i) {
-        const bw_music::Track& track = *sourceTracks[i];
-        traversers.emplace_back(track, track);
-        traversers.back().leastUpperBoundDuration(trackDuration);
-    }
-
-    bw_music::ModelDuration timeSinceStart = 0;
-    while (timeSinceStart < trackDuration) {
-        bw_music::ModelDuration timeToNextEvent = trackDuration - timeSinceStart;
-        for (int i = 0; i < numTracks; ++i) {
-            traversers[i].greatestLowerBoundNextEvent(timeToNextEvent);
+    TrackBuilder trackOut;
+
+    MergingTraverser traverser(sourceTracks);
+    const Timebase& timebase = traverser.getTimebase();
+
+    Ticks timeOfLastEvent = 0;
+    traverser.visitEvents([&trackOut, &timebase, &timeOfLastEvent](int, Ticks time, const Track::const_iterator& it) {
+        const ModelDuration timeSinceLastEvent =
+            (time == timeOfLastEvent) ? ModelDuration(0) : timebase.toModelDuration(time - timeOfLastEvent);
+        if (timeSinceLastEvent == it->getTimeSinceLastEvent()) {
+            trackOut.passThroughEvent(it);
+        } else {
+            TrackEventHolder newEvent = *it;
+            newEvent->setTimeSinceLastEvent(timeSinceLastEvent);
+            trackOut.addEvent(newEvent.release());
         }
+        timeOfLastEvent = time;
+    });
 
-        bool isFirstEvent = true;
-        for (int i = 0; i < numTracks; ++i) {
-            const bw_music::Track& track = *sourceTracks[i];
-            traversers[i].advance(timeToNextEvent,
-                                  [&isFirstEvent, &timeToNextEvent, &trackOut](const TrackEvent& event) {
-                                      TrackEventHolder newEvent = event;
-                                      newEvent->setTimeSinceLastEvent(isFirstEvent ? timeToNextEvent : 0);
-                                      trackOut.addEvent(newEvent.release());
-                                      isFirstEvent = false;
-                                  });
-        }
-
-        timeSinceStart += timeToNextEvent;
-    }
-
-    trackOut.setDuration(trackDuration);
+    trackOut.setDuration(traverser.getDuration());
 
-    return trackOut;
+    return trackOut.finishAndGetTrack();
 }
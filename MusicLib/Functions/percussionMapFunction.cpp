@@ -11,13 +11,18 @@
 #include <MusicLib/Percussion/builtInPercussionInstruments.hpp>
 #include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
 #include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 
 #include <BabelWiresLib/ValueTree/modelExceptions.hpp>
 #include <BabelWiresLib/TypeSystem/typeSystem.hpp>
 #include <BabelWiresLib/Types/Enum/enumAtomTypeConstructor.hpp>
 #include <BabelWiresLib/Types/Enum/enumUnionTypeConstructor.hpp>
+#include <BabelWiresLib/Types/Enum/enumValue.hpp>
 #include <BabelWiresLib/Types/Map/Helpers/enumValueAdapters.hpp>
 #include <BabelWiresLib/Types/Map/Helpers/unorderedMapApplicator.hpp>
+#include <BabelWiresLib/Types/Map/MapEntries/allToSameFallbackMapEntryData.hpp>
+#include <BabelWiresLib/Types/Map/MapEntries/oneToOneMapEntryData.hpp>
+#include <BabelWiresLib/Types/Map/mapValue.hpp>
 #include <BabelWiresLib/Types/Map/mapTypeConstructor.hpp>
 #include <BabelWiresLib/Types/Map/SumOfMaps/sumOfMapsType.hpp>
 #include <BabelWiresLib/Types/Map/standardMapIdentifiers.hpp>
@@ -52,6 +57,27 @@ babelwires::TypeRef bw_music::getPercussionMapType() {
     return babelwires::TypeRef(PercussionMapType::getThisIdentifier(), babelwires::TypeConstructorArguments{});
 }
 
+babelwires::MapValue bw_music::getBuiltInPercussionMap(
+    const babelwires::TypeSystem& typeSystem,
+    const std::vector<std::pair<babelwires::ShortId, babelwires::ShortId>>& replacements) {
+    const babelwires::TypeRef sourceTypeRef = BuiltInPercussionInstruments::getThisType();
+    const babelwires::TypeRef targetTypeRef = babelwires::EnumUnionTypeConstructor::makeTypeRef(
+        sourceTypeRef, babelwires::EnumAtomTypeConstructor::makeTypeRef(babelwires::getBlankValueId()));
+
+    babelwires::MapValue percussionMap;
+    percussionMap.setSourceTypeRef(sourceTypeRef);
+    percussionMap.setTargetTypeRef(targetTypeRef);
+
+    babelwires::OneToOneMapEntryData maplet(typeSystem, sourceTypeRef, targetTypeRef);
+    for (const auto& [source, target] : replacements) {
+        maplet.setSourceValue(babelwires::EnumValue(source));
+        maplet.setTargetValue(babelwires::EnumValue(target));
+        percussionMap.emplaceBack(maplet.clone());
+    }
+    percussionMap.emplaceBack(std::make_unique<babelwires::AllToSameFallbackMapEntryData>());
+    return percussionMap;
+}
+
 bw_music::Track bw_music::mapPercussionFunction(const babelwires::TypeSystem& typeSystem, const Track& trackIn,
                                                 const babelwires::MapValue& percussionMapValue) {
 
@@ -63,17 +89,20 @@ bw_music::Track bw_music::mapPercussionFunction(const babelwires::TypeSystem& ty
     babelwires::UnorderedMapApplicator<babelwires::ShortId, babelwires::ShortId> mapApplicator{
         percussionMapValue, enumToIdentifierAdapter, enumToIdentifierAdapter};
 
-    Track trackOut;
+    TrackBuilder trackOut;
     // If an event is dropped, then we need to carry its time forward for the next event.
     ModelDuration timeFromDroppedEvent;
 
     for (auto it = trackIn.begin(); it != trackIn.end(); ++it) {
         const TrackEvent::GroupingInfo info = it->getGroupingInfo();
         if (info.m_category == PercussionEvent::s_percussionEventCategory) {
-            TrackEventHolder holder(*it);
-            PercussionEvent& percussionEvent = static_cast<PercussionEvent&>(*holder);
-            babelwires::ShortId newInstrument = mapApplicator[percussionEvent.getInstrument()];
-            if (newInstrument != babelwires::getBlankValueId()) {
+            const PercussionEvent& sourceEvent = static_cast<const PercussionEvent&>(*it);
+            babelwires::ShortId newInstrument = mapApplicator[sourceEvent.getInstrument()];
+            if ((newInstrument == sourceEvent.getInstrument()) && (timeFromDroppedEvent == 0)) {
+                trackOut.passThroughEvent(it);
+            } else if (newInstrument != babelwires::getBlankValueId()) {
+                TrackEventHolder holder(*it);
+                PercussionEvent& percussionEvent = static_cast<PercussionEvent&>(*holder);
                 percussionEvent.setInstrument(newInstrument);
                 percussionEvent.setTimeSinceLastEvent(holder->getTimeSinceLastEvent() + timeFromDroppedEvent);
                 timeFromDroppedEvent = 0;
@@ -87,10 +116,10 @@ bw_music::Track bw_music::mapPercussionFunction(const babelwires::TypeSystem& ty
             timeFromDroppedEvent = 0;
             trackOut.addEvent(holder.release());
         } else {
-            trackOut.addEvent(*it);
+            trackOut.passThroughEvent(it);
         }
     }
     trackOut.setDuration(trackIn.getDuration());
 
-    return trackOut;
+    return trackOut.finishAndGetTrack();
 }
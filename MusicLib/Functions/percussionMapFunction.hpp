@@ -10,6 +10,11 @@
 #include <BabelWiresLib/TypeSystem/typeConstructor.hpp>
 #include <BabelWiresLib/Types/Sum/sumType.hpp>
 
+#include <Common/Identifiers/identifier.hpp>
+
+#include <utility>
+#include <vector>
+
 namespace babelwires {
     class MapValue;
     class TypeSystem;
@@ -32,6 +37,12 @@ namespace bw_music {
 
     babelwires::TypeRef getPercussionMapType();
 
+    /// A map of the built-in percussion instruments which replaces each source instrument by its target, and leaves
+    /// other instruments alone. A target of babelwires::getBlankValueId() removes the instrument.
+    babelwires::MapValue
+    getBuiltInPercussionMap(const babelwires::TypeSystem& typeSystem,
+                            const std::vector<std::pair<babelwires::ShortId, babelwires::ShortId>>& replacements);
+
     ///
     Track mapPercussionFunction(const babelwires::TypeSystem& typeSystem, const Track& sourceTrack,
                                 const babelwires::MapValue& percussionMapValue);
@@ -8,12 +8,15 @@
 #include <MusicLib/Functions/quantizeFunction.hpp>
 
 #include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 #include <MusicLib/Functions/sanitizingFunctions.hpp>
 
 namespace {
-    bw_music::ModelDuration getIdealTime(bw_music::ModelDuration time, bw_music::ModelDuration beat) {
-        auto [div, mod] = time.divmod(beat);
-        if (mod >= beat / 2) {
+    bw_music::Ticks getIdealTime(bw_music::Ticks time, bw_music::Ticks beat) {
+        // Times are never negative.
+        bw_music::Ticks div = time / beat;
+        const bw_music::Ticks mod = time % beat;
+        if (2 * mod >= beat) {
             ++div;
         }
         return beat * div;
@@ -21,34 +24,33 @@ namespace {
 } // namespace
 
 bw_music::Track bw_music::quantize(const Track& trackIn, ModelDuration beat) {
+    TrackBuilder trackOut;
 
-    using Group = std::tuple<TrackEvent::GroupingInfo::Category, TrackEvent::GroupingInfo::GroupValue>;
-
-    Track trackOut;
-
-    ModelDuration currentTimeSinceLastEvent;
+    // Work in integer ticks.
+    Timebase timebase = trackIn.getTimebase();
+    timebase.extendToRepresent(beat);
+    timebase.extendToRepresent(trackIn.getDuration());
+    const Ticks beatTicks = timebase.toTicks(beat);
 
     // The absolute time of the current event in trackIn.
-    ModelDuration trackInAbsoluteTime;
-    ModelDuration trackOutAbsoluteTime;
+    Ticks trackInAbsoluteTime = 0;
+    Ticks trackOutAbsoluteTime = 0;
 
     for (auto it = trackIn.begin(); it != trackIn.end(); ++it) {
         const ModelDuration timeSinceLastEvent = it->getTimeSinceLastEvent();
 
-        ModelDuration newTimeSinceLastEvent;
         if (timeSinceLastEvent > 0) {
-            trackInAbsoluteTime += timeSinceLastEvent;
-            const ModelDuration idealTime = getIdealTime(trackInAbsoluteTime, beat);
-            const ModelDuration newTimeSinceLastEvent = idealTime - trackOutAbsoluteTime;
+            trackInAbsoluteTime += timebase.toTicks(timeSinceLastEvent);
+            const Ticks idealTime = getIdealTime(trackInAbsoluteTime, beatTicks);
             TrackEventHolder event = *it;
-            event->setTimeSinceLastEvent(newTimeSinceLastEvent);
+            event->setTimeSinceLastEvent(timebase.toModelDuration(idealTime - trackOutAbsoluteTime));
             trackOut.addEvent(event.release());
-            trackOutAbsoluteTime += newTimeSinceLastEvent;
+            trackOutAbsoluteTime = idealTime;
         } else {
             trackOut.addEvent(*it);
         }
     }
-    const ModelDuration idealDuration = getIdealTime(trackIn.getDuration(), beat);
-    trackOut.setDuration(idealDuration);
-    return removeZeroDurationGroups(trackOut);
+    const Ticks idealDuration = getIdealTime(timebase.toTicks(trackIn.getDuration()), beatTicks);
+    trackOut.setDuration(timebase.toModelDuration(idealDuration));
+    return removeZeroDurationGroups(trackOut.finishAndGetTrack());
 }
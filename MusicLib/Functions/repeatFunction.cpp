@@ -9,6 +9,7 @@
 
 #include <MusicLib/Functions/appendTrackFunction.hpp>
 #include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 
 #include <BabelWiresLib/ValueTree/modelExceptions.hpp>
 
@@ -17,11 +18,11 @@ bw_music::Track bw_music::repeatTrack(const Track& trackIn, int count) {
         throw babelwires::ModelException() << "You cannot have repeat a negative number of times";
     }
 
-    Track trackOut;
+    TrackBuilder trackOut;
 
     for (int i = 0; i < count; ++i) {
         appendTrack(trackOut, trackIn);
     }
 
-    return trackOut;
+    return trackOut.finishAndGetTrack();
 }
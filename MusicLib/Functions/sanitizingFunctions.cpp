@@ -8,6 +8,7 @@
 #include <MusicLib/Functions/sanitizingFunctions.hpp>
 
 #include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 
 #include <set>
 
@@ -17,15 +18,21 @@ bw_music::Track bw_music::removeZeroDurationGroups(const Track& trackIn) {
 
     // This is used to identify groups which have collapsed to zero duration, and so should be removed.
     std::set<Group> groupsStartingAtCurrentTime;
-    std::vector<TrackEventHolder> eventsAtCurrentTime;
+    // Events are only copied if their time has to change.
+    std::vector<Track::const_iterator> eventsAtCurrentTime;
     ModelDuration currentTimeSinceLastEvent;
 
-    Track trackOut;
+    TrackBuilder trackOut;
 
     auto processEventsAtCurrentTime = [&trackOut, &eventsAtCurrentTime, &currentTimeSinceLastEvent]() {
-        for (auto& event : eventsAtCurrentTime) {
-            event->setTimeSinceLastEvent(currentTimeSinceLastEvent);
-            trackOut.addEvent(event.release());
+        for (const auto& event : eventsAtCurrentTime) {
+            if (event->getTimeSinceLastEvent() == currentTimeSinceLastEvent) {
+                trackOut.passThroughEvent(event);
+            } else {
+                TrackEventHolder holder(*event);
+                holder->setTimeSinceLastEvent(currentTimeSinceLastEvent);
+                trackOut.addEvent(holder.release());
+            }
             currentTimeSinceLastEvent = 0;
         }
     };
@@ -51,7 +58,7 @@ bw_music::Track bw_music::removeZeroDurationGroups(const Track& trackIn) {
                 doAddEvent = false;
                 // Remove the collapsed group backwards from the end.
                 for (int i = eventsAtCurrentTime.size() - 1; i >= 0; --i) {
-                    TrackEventHolder& event = eventsAtCurrentTime[i];
+                    const Track::const_iterator& event = eventsAtCurrentTime[i];
                     const TrackEvent::GroupingInfo eventInfo = event->getGroupingInfo();
                     const Group eventGroup = {eventInfo.m_category, eventInfo.m_groupValue};
                     if (eventGroup == group) {
@@ -65,10 +72,10 @@ bw_music::Track bw_music::removeZeroDurationGroups(const Track& trackIn) {
             }
         }
         if (doAddEvent) {
-            eventsAtCurrentTime.emplace_back(*it);
+            eventsAtCurrentTime.emplace_back(it);
         }
     }
     processEventsAtCurrentTime();
     trackOut.setDuration(trackIn.getDuration());
-    return trackOut;
+    return trackOut.finishAndGetTrack();
 }
@@ -0,0 +1,23 @@
+/**
+ * Function which splits a track based on the category of its events.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Functions/splitByCategoryFunction.hpp>
+
+#include <MusicLib/Utilities/trackDemultiplexer.hpp>
+
+#include <algorithm>
+
+std::vector<bw_music::Track>
+bw_music::splitByCategory(const Track& sourceTrack,
+                          const std::vector<TrackEvent::GroupingInfo::Category>& categories) {
+    const int numCategories = categories.size();
+    return demultiplexTrack(sourceTrack, numCategories + 1, [&categories](const TrackEvent& event) -> int {
+        const TrackEvent::GroupingInfo::Category category = event.getGroupingInfo().m_category;
+        // Categories are static strings, so they can be compared by address.
+        return std::find(categories.begin(), categories.end(), category) - categories.begin();
+    });
+}
@@ -0,0 +1,20 @@
+/**
+ * Function which splits a track based on the category of its events.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/Types/Track/track.hpp>
+
+#include <vector>
+
+namespace bw_music {
+    /// Split the events in the track by their category, in a single traversal.
+    /// The result has a track for each of the given categories, in the same order, followed by a track containing
+    /// the events of any other category.
+    std::vector<Track> splitByCategory(const Track& sourceTrack,
+                                       const std::vector<TrackEvent::GroupingInfo::Category>& categories);
+} // namespace bw_music
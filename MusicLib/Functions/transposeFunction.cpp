@@ -8,6 +8,7 @@
 #include <MusicLib/Functions/transposeFunction.hpp>
 
 #include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 
 #include <BabelWiresLib/ValueTree/modelExceptions.hpp>
 
@@ -15,7 +16,7 @@ bw_music::Track bw_music::transposeTrack(const Track& trackIn, int pitchOffset)
     assert(pitchOffset >= -127 && "pitchOffset too low");
     assert(pitchOffset <= 127 && "pitchOffset too high");
 
-    Track trackOut;
+    TrackBuilder trackOut;
     
     for (auto it = trackIn.begin(); it != trackIn.end(); ++it) {
         TrackEventHolder holder(*it);
@@ -24,6 +25,6 @@ bw_music::Track bw_music::transposeTrack(const Track& trackIn, int pitchOffset)
     }
     trackOut.setDuration(trackIn.getDuration());
 
-    return trackOut;
+    return trackOut.finishAndGetTrack();
 }
 
@@ -9,23 +9,26 @@
 
 #include <MusicLib/Percussion/percussionTypeTag.hpp>
 
+#include <algorithm>
 #include <unordered_set>
 
 class bw_music::PercussionSetWithPitchMap::ComplexConstructorArguments {
   public:
     babelwires::EnumType::ValueSet m_enumValues;
-    std::unordered_map<bw_music::Pitch, babelwires::ShortId> m_pitchToInstrument;
-    std::unordered_map<babelwires::ShortId, bw_music::Pitch> m_instrumentToPitch;
+    std::array<std::optional<babelwires::ShortId>, 128> m_pitchToInstrument;
+    std::vector<std::pair<babelwires::ShortId, bw_music::Pitch>> m_instrumentToPitch;
     int m_indexOfDefaultValue = -1;
 
     ComplexConstructorArguments(const InstrumentBlock& instrumentBlock, bw_music::Pitch pitchOfDefaultValue) {
         addInstruments(instrumentBlock, pitchOfDefaultValue);
+        sortInstrumentToPitch();
     }
 
     ComplexConstructorArguments(const std::vector<InstrumentBlock>& instrumentBlocks,
                                 bw_music::Pitch pitchOfDefaultValue) {
         std::for_each(instrumentBlocks.begin(), instrumentBlocks.end(),
                       [this, pitchOfDefaultValue](const auto& b) { addInstruments(b, pitchOfDefaultValue); });
+        sortInstrumentToPitch();
     }
 
     void addInstruments(const InstrumentBlock& instrumentBlock, bw_music::Pitch pitchOfDefaultValue) {
@@ -41,17 +44,22 @@ class bw_music::PercussionSetWithPitchMap::ComplexConstructorArguments {
                 if (pitchOfDefaultValue == pitch) {
                     m_indexOfDefaultValue = m_enumValues.size();
                 }
-                m_instrumentToPitch[id] = pitch;
+                m_instrumentToPitch.emplace_back(id, pitch);
                 m_enumValues.emplace_back(id);
                 m_alreadySeen.insert(id);
             }
-            assert((m_pitchToInstrument.find(pitch) == m_pitchToInstrument.end()) &&
-                   "Duplicate pitch probably because of overlapping blocks");
+            assert((pitch < m_pitchToInstrument.size()) && "Pitch out of MIDI range");
+            assert(!m_pitchToInstrument[pitch] && "Duplicate pitch probably because of overlapping blocks");
             m_pitchToInstrument[pitch] = id;
             ++pitch;
         }
     }
 
+    void sortInstrumentToPitch() {
+        std::sort(m_instrumentToPitch.begin(), m_instrumentToPitch.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+
     ~ComplexConstructorArguments() {
         assert((m_indexOfDefaultValue != -1) &&
                "The default pitch was not found or was the non-lowest pitch of duplicate instrument");
@@ -78,8 +86,9 @@ bw_music::PercussionSetWithPitchMap::PercussionSetWithPitchMap(std::vector<Instr
 
 std::optional<bw_music::Pitch>
 bw_music::PercussionSetWithPitchMap::tryGetPitchFromInstrument(babelwires::ShortId identifier) const {
-    const auto it = m_instrumentToPitch.find(identifier);
-    if (it != m_instrumentToPitch.end()) {
+    const auto it = std::lower_bound(m_instrumentToPitch.begin(), m_instrumentToPitch.end(), identifier,
+                                     [](const auto& entry, babelwires::ShortId id) { return entry.first < id; });
+    if ((it != m_instrumentToPitch.end()) && (it->first == identifier)) {
         return it->second;
     }
     return {};
@@ -87,9 +96,8 @@ bw_music::PercussionSetWithPitchMap::tryGetPitchFromInstrument(babelwires::Short
 
 std::optional<babelwires::ShortId>
 bw_music::PercussionSetWithPitchMap::tryGetInstrumentFromPitch(bw_music::Pitch pitch) const {
-    const auto it = m_pitchToInstrument.find(pitch);
-    if (it != m_pitchToInstrument.end()) {
-        return it->second;
+    if (pitch < m_pitchToInstrument.size()) {
+        return m_pitchToInstrument[pitch];
     }
     return {};
 }
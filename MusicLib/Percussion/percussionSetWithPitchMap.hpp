@@ -10,7 +10,10 @@
 #include <MusicLib/musicTypes.hpp>
 #include <MusicLib/Percussion/builtInPercussionInstruments.hpp>
 
+#include <array>
+#include <optional>
 #include <variant>
+#include <vector>
 
 namespace bw_music {
     /// A convenience class for Enums of percussion instruments which provides support for mapping between instruments and pitch.
@@ -52,7 +55,9 @@ namespace bw_music {
         PercussionSetWithPitchMap(ComplexConstructorArguments&& removeDuplicates);
 
       private:
-        std::unordered_map<bw_music::Pitch, babelwires::ShortId> m_pitchToInstrument;
-        std::unordered_map<babelwires::ShortId, bw_music::Pitch> m_instrumentToPitch;
+        /// Indexed by MIDI pitch.
+        std::array<std::optional<babelwires::ShortId>, 128> m_pitchToInstrument;
+        /// Sorted by instrument, so lookups are a binary search over contiguous memory.
+        std::vector<std::pair<babelwires::ShortId, bw_music::Pitch>> m_instrumentToPitch;
     };
 }
@@ -30,22 +30,21 @@ bw_music::ChordMapProcessorOutput::ChordMapProcessorOutput()
                                               bw_music::DefaultTrackType::getThisType()) {}
 
 bw_music::ChordMapProcessor::ChordMapProcessor(const babelwires::ProjectContext& projectContext)
-    : babelwires::ParallelProcessor(projectContext, ChordMapProcessorInput::getThisType(),
-                                    ChordMapProcessorOutput::getThisType()) {}
+    : ParallelTrackProcessor(projectContext, ChordMapProcessorInput::getThisType(),
+                             ChordMapProcessorOutput::getThisType()) {}
 
 babelwires::ShortId bw_music::ChordMapProcessor::getCommonArrayId() {
     return BW_SHORT_ID("Tracks", "Tracks", "24e56b0d-eb1e-4c93-97fd-ba4d639e112a");
 }
 
-void bw_music::ChordMapProcessor::processEntry(babelwires::UserLogger& userLogger,
-                                               const babelwires::ValueTreeNode& input,
-                                               const babelwires::ValueTreeNode& inputEntry,
-                                               babelwires::ValueTreeNode& outputEntry) const {
+void bw_music::ChordMapProcessor::prepareToProcessTracks(const babelwires::ValueTreeNode& input) const {
     ChordMapProcessorInput::ConstInstance in{input};
-    babelwires::ConstInstance<TrackType> entryIn{inputEntry};
-    babelwires::Instance<TrackType> entryOut{outputEntry};
-
     const auto& chordMap = in.getChrdMp()->getValue()->is<babelwires::MapValue>();
+    m_compiledChordMap.emplace(in->getTypeSystem(), chordMap);
+}
 
-    entryOut.set(mapChordsFunction(in->getTypeSystem(), entryIn.get(), chordMap));
+bw_music::Track bw_music::ChordMapProcessor::processTrack(const babelwires::ValueTreeNode& input,
+                                                          const Track& trackIn) const {
+    assert(m_compiledChordMap && "The chord map was not prepared");
+    return mapChordsFunction(*m_compiledChordMap, trackIn);
 }
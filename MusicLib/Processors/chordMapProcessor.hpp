@@ -7,13 +7,16 @@
  **/
 #pragma once
 
+#include <MusicLib/Functions/mapChordsFunction.hpp>
+#include <MusicLib/Processors/parallelTrackProcessor.hpp>
 #include <MusicLib/instance.hpp>
 
-#include <BabelWiresLib/Processors/parallelProcessor.hpp>
 #include <BabelWiresLib/Types/Rational/rationalType.hpp>
 #include <BabelWiresLib/Types/Map/mapType.hpp>
 #include <BabelWiresLib/Processors/processorFactory.hpp>
 
+#include <optional>
+
 namespace bw_music {
 
     class ChordMapProcessorInput : public babelwires::ParallelProcessorInputBase {
@@ -35,7 +38,7 @@ namespace bw_music {
     };
 
     /// A processor which chordmaps the events in a track a specified number of times.
-    class ChordMapProcessor : public babelwires::ParallelProcessor {
+    class ChordMapProcessor : public ParallelTrackProcessor {
       public:
         BW_PROCESSOR_WITH_DEFAULT_FACTORY("ChordMapProcessor", "Chord Map", "b7227130-8274-4451-bd60-8fe34a74c4b6");
 
@@ -43,8 +46,13 @@ namespace bw_music {
 
         static babelwires::ShortId getCommonArrayId();
 
-        void processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
-                          const babelwires::ValueTreeNode& inputEntry, babelwires::ValueTreeNode& outputEntry) const override;
+      protected:
+        void prepareToProcessTracks(const babelwires::ValueTreeNode& input) const override;
+        Track processTrack(const babelwires::ValueTreeNode& input, const Track& trackIn) const override;
+
+      private:
+        /// The chord map of the current input, compiled once and shared by all entries.
+        mutable std::optional<CompiledChordMap> m_compiledChordMap;
     };
 
 } // namespace bw_music
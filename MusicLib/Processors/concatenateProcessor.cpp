@@ -8,6 +8,7 @@
 #include <MusicLib/Processors/concatenateProcessor.hpp>
 
 #include <MusicLib/Functions/appendTrackFunction.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 
 #include <BabelWiresLib/Types/Array/arrayTypeConstructor.hpp>
 #include <BabelWiresLib/Types/Int/intTypeConstructor.hpp>
@@ -30,7 +31,7 @@ void bw_music::ConcatenateProcessor::processValue(babelwires::UserLogger& userLo
                                                   babelwires::ValueTreeNode& output) const {
     ConcatenateProcessorInput::ConstInstance in{input};
     if (in->isChanged(babelwires::ValueTreeNode::Changes::SomethingChanged)) {
-        Track trackOut;
+        TrackBuilder trackOut;
 
         for (int i = 0; i < in.getInput().getSize(); ++i) {
             appendTrack(trackOut, in.getInput().getEntry(i).get());
@@ -38,6 +39,6 @@ void bw_music::ConcatenateProcessor::processValue(babelwires::UserLogger& userLo
 
         ConcatenateProcessorOutput::Instance out{output};
 
-        out.getOutput().set(std::move(trackOut));
+        out.getOutput().set(trackOut.finishAndGetTrack());
     }
 }
@@ -30,16 +30,11 @@ babelwires::ShortId bw_music::ExcerptProcessor::getCommonArrayId() {
 }
 
 bw_music::ExcerptProcessor::ExcerptProcessor(const babelwires::ProjectContext& projectContext)
-    : babelwires::ParallelProcessor(projectContext, ExcerptProcessorInput::getThisType(),
-                                    ExcerptProcessorOutput::getThisType()) {}
+    : ParallelTrackProcessor(projectContext, ExcerptProcessorInput::getThisType(),
+                             ExcerptProcessorOutput::getThisType()) {}
 
-void bw_music::ExcerptProcessor::processEntry(babelwires::UserLogger& userLogger,
-                                              const babelwires::ValueTreeNode& input,
-                                              const babelwires::ValueTreeNode& inputEntry,
-                                              babelwires::ValueTreeNode& outputEntry) const {
+bw_music::Track bw_music::ExcerptProcessor::processTrack(const babelwires::ValueTreeNode& input,
+                                                         const Track& trackIn) const {
     ExcerptProcessorInput::ConstInstance in{input};
-    babelwires::ConstInstance<TrackType> entryIn{inputEntry};
-    babelwires::Instance<TrackType> entryOut{outputEntry};
-
-    entryOut.set(getTrackExcerpt(entryIn.get(), in.getStart().get(), in.getDuratn().get()));
+    return getTrackExcerpt(trackIn, in.getStart().get(), in.getDuratn().get());
 }
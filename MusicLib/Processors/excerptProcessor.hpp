@@ -7,8 +7,9 @@
  **/
 #pragma once
 
+#include <MusicLib/Processors/parallelTrackProcessor.hpp>
+
 #include <BabelWiresLib/Instance/instance.hpp>
-#include <BabelWiresLib/Processors/parallelProcessor.hpp>
 #include <BabelWiresLib/Processors/processorFactory.hpp>
 
 namespace bw_music {
@@ -34,7 +35,7 @@ namespace bw_music {
     };
 
     /// A processor which limits a track to events between certain points.
-    class ExcerptProcessor : public babelwires::ParallelProcessor {
+    class ExcerptProcessor : public ParallelTrackProcessor {
       public:
         BW_PROCESSOR_WITH_DEFAULT_FACTORY("TrackExcerpt", "Excerpt", "83c74dba-7861-447c-9abb-0b4439061baf");
 
@@ -42,8 +43,8 @@ namespace bw_music {
 
         static babelwires::ShortId getCommonArrayId();
 
-        void processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
-                          const babelwires::ValueTreeNode& inputEntry, babelwires::ValueTreeNode& outputEntry) const override;
+      protected:
+        Track processTrack(const babelwires::ValueTreeNode& input, const Track& trackIn) const override;
     };
 
 } // namespace bw_music
@@ -0,0 +1,82 @@
+/**
+ * A ParallelProcessor whose entries are tracks, which are processed concurrently.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Processors/parallelTrackProcessor.hpp>
+
+#include <MusicLib/Types/Track/trackInstance.hpp>
+#include <MusicLib/Utilities/parallelFor.hpp>
+
+#include <exception>
+#include <optional>
+
+namespace {
+    bw_music::ParallelTrackProcessor::Executor& getExecutor() {
+        static bw_music::ParallelTrackProcessor::Executor s_executor;
+        return s_executor;
+    }
+} // namespace
+
+bw_music::ParallelTrackProcessor::ParallelTrackProcessor(const babelwires::ProjectContext& projectContext,
+                                                         const babelwires::TypeRef& inputTypeRef,
+                                                         const babelwires::TypeRef& outputTypeRef)
+    : babelwires::ParallelProcessor(projectContext, inputTypeRef, outputTypeRef) {}
+
+void bw_music::ParallelTrackProcessor::setExecutor(Executor executor) {
+    getExecutor() = std::move(executor);
+}
+
+void bw_music::ParallelTrackProcessor::prepareToProcessTracks(const babelwires::ValueTreeNode& input) const {}
+
+void bw_music::ParallelTrackProcessor::processEntry(babelwires::UserLogger& userLogger,
+                                                    const babelwires::ValueTreeNode& input,
+                                                    const babelwires::ValueTreeNode& inputEntry,
+                                                    babelwires::ValueTreeNode& outputEntry) const {
+    m_pendingEntries.emplace_back(PendingEntry{&inputEntry, &outputEntry});
+}
+
+void bw_music::ParallelTrackProcessor::processValue(babelwires::UserLogger& userLogger,
+                                                    const babelwires::ValueTreeNode& input,
+                                                    babelwires::ValueTreeNode& output) const {
+    m_pendingEntries.clear();
+    babelwires::ParallelProcessor::processValue(userLogger, input, output);
+    if (m_pendingEntries.empty()) {
+        return;
+    }
+    try {
+        prepareToProcessTracks(input);
+    } catch (...) {
+        m_pendingEntries.clear();
+        throw;
+    }
+
+    // Setting a value can mark ancestors as changed, so the outputs are only set on this thread.
+    std::vector<std::optional<Track>> results(m_pendingEntries.size());
+    std::vector<std::exception_ptr> exceptions(m_pendingEntries.size());
+    const auto task = [this, &input, &results, &exceptions](std::size_t i) {
+        try {
+            babelwires::ConstInstance<TrackType> entryIn{*m_pendingEntries[i].m_inputEntry};
+            results[i].emplace(processTrack(input, entryIn.get()));
+        } catch (...) {
+            exceptions[i] = std::current_exception();
+        }
+    };
+    if (const Executor& executor = getExecutor()) {
+        executor(m_pendingEntries.size(), task);
+    } else {
+        parallelFor(m_pendingEntries.size(), 0, task);
+    }
+
+    for (std::size_t i = 0; i < m_pendingEntries.size(); ++i) {
+        if (exceptions[i]) {
+            m_pendingEntries.clear();
+            std::rethrow_exception(exceptions[i]);
+        }
+        babelwires::Instance<TrackType> entryOut{*m_pendingEntries[i].m_outputEntry};
+        entryOut.set(std::move(*results[i]));
+    }
+    m_pendingEntries.clear();
+}
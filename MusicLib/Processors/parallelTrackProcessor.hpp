@@ -0,0 +1,64 @@
+/**
+ * A ParallelProcessor whose entries are tracks, which are processed concurrently.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/Types/Track/track.hpp>
+
+#include <BabelWiresLib/Processors/parallelProcessor.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace bw_music {
+
+    /// A ParallelProcessor whose array entries are tracks.
+    /// The entries which need processing are collected by processEntry and then passed to processTrack using the
+    /// executor, so the tracks of one input are processed concurrently. The results are stored in the output on the
+    /// calling thread, in entry order.
+    class ParallelTrackProcessor : public babelwires::ParallelProcessor {
+      public:
+        ParallelTrackProcessor(const babelwires::ProjectContext& projectContext, const babelwires::TypeRef& inputTypeRef,
+                               const babelwires::TypeRef& outputTypeRef);
+
+        /// An executor calls the function with each index in [0, numTasks) and returns when all calls are complete.
+        /// The calls may be made concurrently. If any calls throw, the executor must rethrow one of the exceptions.
+        using Executor = std::function<void(std::size_t numTasks, const std::function<void(std::size_t)>& task)>;
+
+        /// Replace the executor used by all ParallelTrackProcessors, for example to share an application's thread
+        /// pool. Passing an empty executor restores the default, which uses parallelFor and the hardware threads.
+        /// This must not be called while processors are running.
+        static void setExecutor(Executor executor);
+
+      protected:
+        /// Called on the calling thread before the tracks are processed, so implementations can prepare state
+        /// which processTrack shares between entries. It is only called when some tracks need processing.
+        virtual void prepareToProcessTracks(const babelwires::ValueTreeNode& input) const;
+
+        /// Return the processed version of trackIn.
+        /// This is called concurrently for different entries of the same input, so implementations must not modify
+        /// any shared state. The input can be read freely.
+        virtual Track processTrack(const babelwires::ValueTreeNode& input, const Track& trackIn) const = 0;
+
+        void processValue(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
+                          babelwires::ValueTreeNode& output) const override;
+
+        void processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
+                          const babelwires::ValueTreeNode& inputEntry,
+                          babelwires::ValueTreeNode& outputEntry) const override;
+
+      private:
+        struct PendingEntry {
+            const babelwires::ValueTreeNode* m_inputEntry;
+            babelwires::ValueTreeNode* m_outputEntry;
+        };
+
+        /// The entries collected during the current call to processValue.
+        mutable std::vector<PendingEntry> m_pendingEntries;
+    };
+
+} // namespace bw_music
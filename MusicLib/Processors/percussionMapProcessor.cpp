@@ -25,22 +25,16 @@ bw_music::PercussionMapProcessorOutput::PercussionMapProcessorOutput()
                                                    bw_music::DefaultTrackType::getThisType()) {}
 
 bw_music::PercussionMapProcessor::PercussionMapProcessor(const babelwires::ProjectContext& projectContext)
-    : babelwires::ParallelProcessor(projectContext, PercussionMapProcessorInput::getThisType(),
-                                         PercussionMapProcessorOutput::getThisType()) {}
+    : ParallelTrackProcessor(projectContext, PercussionMapProcessorInput::getThisType(),
+                             PercussionMapProcessorOutput::getThisType()) {}
 
 babelwires::ShortId bw_music::PercussionMapProcessor::getCommonArrayId() {
     return BW_SHORT_ID("Tracks", "Tracks", "fe71b1c6-6604-430b-a731-f40b2692d2cf");
 }
 
-void bw_music::PercussionMapProcessor::processEntry(babelwires::UserLogger& userLogger,
-                                                    const babelwires::ValueTreeNode& input,
-                                                    const babelwires::ValueTreeNode& inputEntry,
-                                                    babelwires::ValueTreeNode& outputEntry) const {
+bw_music::Track bw_music::PercussionMapProcessor::processTrack(const babelwires::ValueTreeNode& input,
+                                                               const Track& trackIn) const {
     PercussionMapProcessorInput::ConstInstance in{input};
-    babelwires::ConstInstance<TrackType> entryIn{inputEntry};
-    babelwires::Instance<TrackType> entryOut{outputEntry};
-
     const auto& percMap = in.getMap()->getValue()->is<babelwires::MapValue>();
-
-    entryOut.set(mapPercussionFunction(in->getTypeSystem(), entryIn.get(), percMap));
+    return mapPercussionFunction(in->getTypeSystem(), trackIn, percMap);
 }
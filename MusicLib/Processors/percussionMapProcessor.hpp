@@ -7,9 +7,9 @@
  **/
 #pragma once
 
+#include <MusicLib/Processors/parallelTrackProcessor.hpp>
 #include <MusicLib/instance.hpp>
 
-#include <BabelWiresLib/Processors/parallelProcessor.hpp>
 #include <BabelWiresLib/Types/Rational/rationalType.hpp>
 #include <BabelWiresLib/Types/Map/mapType.hpp>
 #include <BabelWiresLib/Processors/processorFactory.hpp>
@@ -35,7 +35,7 @@ namespace bw_music {
     };
 
     /// A processor which percussionmaps the events in a track a specified number of times.
-    class PercussionMapProcessor : public babelwires::ParallelProcessor {
+    class PercussionMapProcessor : public ParallelTrackProcessor {
       public:
         BW_PROCESSOR_WITH_DEFAULT_FACTORY("PercussionMapProcessor", "Percussion Map", "1ab6fd2b-8176-4516-9d9a-3b2d91a53f42");
 
@@ -43,8 +43,8 @@ namespace bw_music {
 
         static babelwires::ShortId getCommonArrayId();
 
-        void processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
-                          const babelwires::ValueTreeNode& inputEntry, babelwires::ValueTreeNode& outputEntry) const override;
+      protected:
+        Track processTrack(const babelwires::ValueTreeNode& input, const Track& trackIn) const override;
     };
 
 } // namespace bw_music
@@ -29,20 +29,15 @@ bw_music::QuantizeProcessorOutput::QuantizeProcessorOutput()
                                                    bw_music::DefaultTrackType::getThisType()) {}
 
 bw_music::QuantizeProcessor::QuantizeProcessor(const babelwires::ProjectContext& projectContext)
-    : babelwires::ParallelProcessor(projectContext, QuantizeProcessorInput::getThisType(),
-                                         QuantizeProcessorOutput::getThisType()) {}
+    : ParallelTrackProcessor(projectContext, QuantizeProcessorInput::getThisType(),
+                             QuantizeProcessorOutput::getThisType()) {}
 
 babelwires::ShortId bw_music::QuantizeProcessor::getCommonArrayId() {
     return BW_SHORT_ID("Tracks", "Tracks", "e00623bf-c0f0-4fee-b6c4-4f65df896bf3");
 }
 
-void bw_music::QuantizeProcessor::processEntry(babelwires::UserLogger& userLogger,
-                                             const babelwires::ValueTreeNode& input,
-                                             const babelwires::ValueTreeNode& inputEntry,
-                                             babelwires::ValueTreeNode& outputEntry) const {
+bw_music::Track bw_music::QuantizeProcessor::processTrack(const babelwires::ValueTreeNode& input,
+                                                          const Track& trackIn) const {
     QuantizeProcessorInput::ConstInstance in{input};
-    babelwires::ConstInstance<TrackType> entryIn{inputEntry};
-    babelwires::Instance<TrackType> entryOut{outputEntry};
-
-    entryOut.set(quantize(entryIn.get(), in.getBeat().get()));
+    return quantize(trackIn, in.getBeat().get());
 }
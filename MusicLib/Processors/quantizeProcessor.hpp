@@ -7,9 +7,9 @@
  **/
 #pragma once
 
+#include <MusicLib/Processors/parallelTrackProcessor.hpp>
 #include <MusicLib/instance.hpp>
 
-#include <BabelWiresLib/Processors/parallelProcessor.hpp>
 #include <BabelWiresLib/Types/Rational/rationalType.hpp>
 #include <BabelWiresLib/Processors/processorFactory.hpp>
 
@@ -36,7 +36,7 @@ namespace bw_music {
     };
 
     /// A processor which quantizes the events in a track a specified number of times.
-    class QuantizeProcessor : public babelwires::ParallelProcessor {
+    class QuantizeProcessor : public ParallelTrackProcessor {
       public:
         BW_PROCESSOR_WITH_DEFAULT_FACTORY("QuantizeTracks", "Quantize", "1ae89077-2cfb-4071-910c-2f5dcfc85b17");
 
@@ -44,8 +44,8 @@ namespace bw_music {
 
         static babelwires::ShortId getCommonArrayId();
 
-        void processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
-                          const babelwires::ValueTreeNode& inputEntry, babelwires::ValueTreeNode& outputEntry) const override;
+      protected:
+        Track processTrack(const babelwires::ValueTreeNode& input, const Track& trackIn) const override;
     };
 
 } // namespace bw_music
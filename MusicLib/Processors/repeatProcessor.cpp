@@ -8,6 +8,7 @@
 #include <MusicLib/Processors/repeatProcessor.hpp>
 
 #include <MusicLib/Functions/appendTrackFunction.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 #include <MusicLib/Types/Track/trackInstance.hpp>
 
 #include <BabelWiresLib/Types/Int/intTypeConstructor.hpp>
@@ -27,24 +28,19 @@ bw_music::RepeatProcessorOutput::RepeatProcessorOutput()
                                               bw_music::DefaultTrackType::getThisType()) {}
 
 bw_music::RepeatProcessor::RepeatProcessor(const babelwires::ProjectContext& projectContext)
-    : babelwires::ParallelProcessor(projectContext, RepeatProcessorInput::getThisType(),
-                                    RepeatProcessorOutput::getThisType()) {}
+    : ParallelTrackProcessor(projectContext, RepeatProcessorInput::getThisType(),
+                             RepeatProcessorOutput::getThisType()) {}
 
 babelwires::ShortId bw_music::RepeatProcessor::getCommonArrayId() {
     return BW_SHORT_ID("Tracks", "Tracks", "f727937f-0215-4527-bab4-0eca269d6c5c");
 }
 
-void bw_music::RepeatProcessor::processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
-                                             const babelwires::ValueTreeNode& inputEntry,
-                                             babelwires::ValueTreeNode& outputEntry) const {
+bw_music::Track bw_music::RepeatProcessor::processTrack(const babelwires::ValueTreeNode& input,
+                                                        const Track& trackIn) const {
     RepeatProcessorInput::ConstInstance in{input};
-    babelwires::ConstInstance<TrackType> entryIn{inputEntry};
-    babelwires::Instance<TrackType> entryOut{outputEntry};
-    Track trackOut;
-
-    const Track& trackIn = entryIn.get();
+    TrackBuilder trackOut;
     for (int i = 0; i < in.getCount().get(); ++i) {
         appendTrack(trackOut, trackIn);
     }
-    entryOut.set(std::move(trackOut));
+    return trackOut.finishAndGetTrack();
 }
@@ -7,8 +7,9 @@
  **/
 #pragma once
 
+#include <MusicLib/Processors/parallelTrackProcessor.hpp>
+
 #include <BabelWiresLib/Instance/instance.hpp>
-#include <BabelWiresLib/Processors/parallelProcessor.hpp>
 #include <BabelWiresLib/Processors/processorFactory.hpp>
 
 namespace bw_music {
@@ -32,7 +33,7 @@ namespace bw_music {
     };
 
     /// A processor which repeats the events in a track a specified number of times.
-    class RepeatProcessor : public babelwires::ParallelProcessor {
+    class RepeatProcessor : public ParallelTrackProcessor {
       public:
         BW_PROCESSOR_WITH_DEFAULT_FACTORY("RepeatTracks", "Repeat", "6c5b3e89-bb57-4c90-8a66-1d8cdeb29db9");
 
@@ -40,8 +41,8 @@ namespace bw_music {
 
         static babelwires::ShortId getCommonArrayId();
 
-        void processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
-                          const babelwires::ValueTreeNode& inputEntry, babelwires::ValueTreeNode& outputEntry) const override;
+      protected:
+        Track processTrack(const babelwires::ValueTreeNode& input, const Track& trackIn) const override;
     };
 
 } // namespace bw_music
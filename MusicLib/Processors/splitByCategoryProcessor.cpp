@@ -0,0 +1,50 @@
+/**
+ * A processor which splits a track into tracks for each category of event.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Processors/splitByCategoryProcessor.hpp>
+
+#include <MusicLib/Functions/splitByCategoryFunction.hpp>
+#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
+
+#include <Common/Identifiers/registeredIdentifier.hpp>
+
+bw_music::SplitByCategoryProcessorInput::SplitByCategoryProcessorInput()
+    : babelwires::RecordType({{BW_SHORT_ID("Input", "Input Track", "a1bba0e5-48ed-44de-b674-612344af1b1c"),
+                               DefaultTrackType::getThisType()}}) {}
+
+bw_music::SplitByCategoryProcessorOutput::SplitByCategoryProcessorOutput()
+    : babelwires::RecordType({
+          {BW_SHORT_ID("Notes", "Notes", "c1f04b3a-d6e4-406d-9eb1-8e9cebd1dbe3"), DefaultTrackType::getThisType()},
+          {BW_SHORT_ID("Chords", "Chords", "d9f63b90-4b5e-4c34-8897-4637891e272b"), DefaultTrackType::getThisType()},
+          {BW_SHORT_ID("Percussion", "Percussion", "5424afed-5615-4ac1-9f63-f36b9dc9a965"),
+           DefaultTrackType::getThisType()},
+          {BW_SHORT_ID("Other", "Other", "fa154d2e-347e-4341-bdb1-872a77fa2b1a"), DefaultTrackType::getThisType()},
+      }) {}
+
+bw_music::SplitByCategoryProcessor::SplitByCategoryProcessor(const babelwires::ProjectContext& projectContext)
+    : Processor(projectContext, SplitByCategoryProcessorInput::getThisType(),
+                SplitByCategoryProcessorOutput::getThisType()) {}
+
+void bw_music::SplitByCategoryProcessor::processValue(babelwires::UserLogger& userLogger,
+                                                      const babelwires::ValueTreeNode& input,
+                                                      babelwires::ValueTreeNode& output) const {
+    SplitByCategoryProcessorInput::ConstInstance in{input};
+    auto trackIn = in.getInput();
+    if (trackIn->isChanged(babelwires::ValueTreeNode::Changes::SomethingChanged)) {
+        // The order must match the fields of the output.
+        std::vector<Track> tracksOut =
+            splitByCategory(trackIn.get(), {NoteEvent::s_noteEventCategory, ChordEvent::s_chordEventCategory,
+                                            PercussionEvent::s_percussionEventCategory});
+        SplitByCategoryProcessorOutput::Instance out{output};
+        out.getNotes().set(std::move(tracksOut[0]));
+        out.getChords().set(std::move(tracksOut[1]));
+        out.getPercussion().set(std::move(tracksOut[2]));
+        out.getOther().set(std::move(tracksOut[3]));
+    }
+}
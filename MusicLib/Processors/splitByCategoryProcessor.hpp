@@ -0,0 +1,58 @@
+/**
+ * A processor which splits a track into tracks for each category of event.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/Types/Track/trackInstance.hpp>
+#include <MusicLib/Types/Track/trackType.hpp>
+
+#include <BabelWiresLib/Instance/instance.hpp>
+#include <BabelWiresLib/Processors/processorFactory.hpp>
+#include <BabelWiresLib/Processors/processor.hpp>
+#include <BabelWiresLib/TypeSystem/primitiveType.hpp>
+#include <BabelWiresLib/Types/Record/recordType.hpp>
+
+namespace bw_music {
+    class SplitByCategoryProcessorInput : public babelwires::RecordType {
+      public:
+        PRIMITIVE_TYPE("CategorySplitIn", "Split By Category Input", "079dc8c0-3821-4b73-b5ff-755478eb5cac", 1);
+
+        SplitByCategoryProcessorInput();
+
+        DECLARE_INSTANCE_BEGIN(SplitByCategoryProcessorInput)
+        DECLARE_INSTANCE_FIELD(Input, bw_music::TrackType)
+        DECLARE_INSTANCE_END()
+    };
+
+    /// A record with a track for each of the categories of event known to this library.
+    class SplitByCategoryProcessorOutput : public babelwires::RecordType {
+      public:
+        PRIMITIVE_TYPE("CategorySplitOut", "Split By Category Output", "dc2de52c-61a2-434a-8b7b-475606b5a146", 1);
+
+        SplitByCategoryProcessorOutput();
+
+        DECLARE_INSTANCE_BEGIN(SplitByCategoryProcessorOutput)
+        DECLARE_INSTANCE_FIELD(Notes, bw_music::TrackType)
+        DECLARE_INSTANCE_FIELD(Chords, bw_music::TrackType)
+        DECLARE_INSTANCE_FIELD(Percussion, bw_music::TrackType)
+        DECLARE_INSTANCE_FIELD(Other, bw_music::TrackType)
+        DECLARE_INSTANCE_END()
+    };
+
+    class SplitByCategoryProcessor : public babelwires::Processor {
+      public:
+        BW_PROCESSOR_WITH_DEFAULT_FACTORY("SplitByCategoryProcessor", "Split By Category",
+                                          "f92ef8e0-f7f5-498c-a349-fc395fd03f32");
+
+        SplitByCategoryProcessor(const babelwires::ProjectContext& projectContext);
+
+      protected:
+        void processValue(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
+                          babelwires::ValueTreeNode& output) const override;
+    };
+
+} // namespace bw_music
@@ -24,8 +24,8 @@ bw_music::TransposeProcessorInput::TransposeProcessorInput()
           TransposeProcessor::getCommonArrayId(), bw_music::DefaultTrackType::getThisType()) {}
 
 bw_music::TransposeProcessor::TransposeProcessor(const babelwires::ProjectContext& projectContext)
-    : babelwires::ParallelProcessor(projectContext, TransposeProcessorInput::getThisType(),
-                                    TransposeProcessorOutput::getThisType()) {}
+    : ParallelTrackProcessor(projectContext, TransposeProcessorInput::getThisType(),
+                             TransposeProcessorOutput::getThisType()) {}
 
 bw_music::TransposeProcessorOutput::TransposeProcessorOutput()
     : babelwires::ParallelProcessorOutputBase(TransposeProcessor::getCommonArrayId(),
@@ -35,13 +35,8 @@ babelwires::ShortId bw_music::TransposeProcessor::getCommonArrayId() {
     return BW_SHORT_ID("Tracks", "Tracks", "83f05b66-7890-4542-8344-1409e50539b5");
 }
 
-void bw_music::TransposeProcessor::processEntry(babelwires::UserLogger& userLogger,
-                                                const babelwires::ValueTreeNode& input,
-                                                const babelwires::ValueTreeNode& inputEntry,
-                                                babelwires::ValueTreeNode& outputEntry) const {
+bw_music::Track bw_music::TransposeProcessor::processTrack(const babelwires::ValueTreeNode& input,
+                                                           const Track& trackIn) const {
     TransposeProcessorInput::ConstInstance in{input};
-    babelwires::ConstInstance<TrackType> entryIn{inputEntry};
-    babelwires::Instance<TrackType> entryOut{outputEntry};
-
-    entryOut.set(transposeTrack(entryIn.get(), in.getOffset().get()));
+    return transposeTrack(trackIn, in.getOffset().get());
 }
@@ -7,8 +7,9 @@
  **/
 #pragma once
 
+#include <MusicLib/Processors/parallelTrackProcessor.hpp>
+
 #include <BabelWiresLib/Instance/instance.hpp>
-#include <BabelWiresLib/Processors/parallelProcessor.hpp>
 #include <BabelWiresLib/Processors/processorFactory.hpp>
 
 namespace bw_music {
@@ -33,7 +34,7 @@ namespace bw_music {
 
 
     /// A processor that adjusts the pitch of note events.
-    class TransposeProcessor : public babelwires::ParallelProcessor {
+    class TransposeProcessor : public ParallelTrackProcessor {
       public:
         BW_PROCESSOR_WITH_DEFAULT_FACTORY("TransposeTracks", "Transpose", "3414f6cf-290a-421e-bce5-6a98ed0483af");
 
@@ -41,8 +42,8 @@ namespace bw_music {
 
         static babelwires::ShortId getCommonArrayId();
 
-        void processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
-                          const babelwires::ValueTreeNode& inputEntry, babelwires::ValueTreeNode& outputEntry) const override;
+      protected:
+        Track processTrack(const babelwires::ValueTreeNode& input, const Track& trackIn) const override;
     };
 
 } // namespace bw_music
@@ -0,0 +1,36 @@
+/**
+ * A Timebase allows durations to be handled as integer numbers of ticks.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Types/Track/timebase.hpp>
+
+#include <numeric>
+#include <utility>
+
+bw_music::Timebase::Timebase(int ticksPerWholeNote)
+    : m_ticksPerWholeNote(ticksPerWholeNote) {
+    assert((ticksPerWholeNote > 0) && "A timebase must have a positive number of ticks");
+}
+
+int bw_music::Timebase::extendToRepresent(ModelDuration duration) {
+    if (canRepresent(duration)) {
+        return 1;
+    }
+    return extendToRepresent(Timebase(duration.getDenominator()));
+}
+
+int bw_music::Timebase::extendToRepresent(const Timebase& other) {
+    const int newTicksPerWholeNote = babelwires::lcm(m_ticksPerWholeNote, other.m_ticksPerWholeNote);
+    const int factor = newTicksPerWholeNote / m_ticksPerWholeNote;
+    m_ticksPerWholeNote = newTicksPerWholeNote;
+    return factor;
+}
+
+bw_music::ModelDuration bw_music::Timebase::toModelDuration(Ticks ticks) const {
+    using Component = decltype(std::declval<ModelDuration>().getNumerator());
+    const Ticks divisor = std::gcd(ticks, static_cast<Ticks>(m_ticksPerWholeNote));
+    return ModelDuration(static_cast<Component>(ticks / divisor), static_cast<Component>(m_ticksPerWholeNote / divisor));
+}
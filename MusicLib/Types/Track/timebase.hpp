@@ -0,0 +1,58 @@
+/**
+ * A Timebase allows durations to be handled as integer numbers of ticks.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicTypes.hpp>
+
+#include <cassert>
+#include <cstdint>
+
+namespace bw_music {
+    /// A duration measured in the ticks of some timebase.
+    using Ticks = std::int64_t;
+
+    /// A timebase divides a whole note into a number of ticks. Durations which are multiples of a tick can be
+    /// handled as integers, which avoids the cost of normalizing rationals after every operation.
+    class Timebase {
+      public:
+        Timebase() = default;
+
+        /// A timebase whose tick has length 1/ticksPerWholeNote.
+        explicit Timebase(int ticksPerWholeNote);
+
+        int getTicksPerWholeNote() const { return m_ticksPerWholeNote; }
+
+        /// Can the duration be represented exactly as a number of ticks?
+        bool canRepresent(ModelDuration duration) const {
+            return (m_ticksPerWholeNote % duration.getDenominator()) == 0;
+        }
+
+        /// Refine the timebase, if necessary, so it can also represent the duration.
+        /// Returns the factor by which ticks of the old timebase have to be multiplied.
+        int extendToRepresent(ModelDuration duration);
+
+        /// Refine the timebase, if necessary, so it can also represent any duration the other timebase can.
+        /// Returns the factor by which ticks of the old timebase have to be multiplied.
+        int extendToRepresent(const Timebase& other);
+
+        /// The duration must be representable.
+        Ticks toTicks(ModelDuration duration) const {
+            assert(canRepresent(duration) && "The duration cannot be represented in this timebase");
+            return static_cast<Ticks>(duration.getNumerator()) * (m_ticksPerWholeNote / duration.getDenominator());
+        }
+
+        /// Get a ModelDuration corresponding to the number of ticks.
+        ModelDuration toModelDuration(Ticks ticks) const;
+
+        bool operator==(const Timebase& other) const { return m_ticksPerWholeNote == other.m_ticksPerWholeNote; }
+        bool operator!=(const Timebase& other) const { return m_ticksPerWholeNote != other.m_ticksPerWholeNote; }
+
+      private:
+        int m_ticksPerWholeNote = 1;
+    };
+} // namespace bw_music
@@ -7,8 +7,21 @@
  **/
 #include <MusicLib/Types/Track/track.hpp>
 
+#include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
+
 #include <Common/Hash/hash.hpp>
 
+#include <algorithm>
+#include <atomic>
+
+namespace {
+    /// The end iterator needs some stream to point into.
+    const babelwires::BlockStream& getEmptyStream() {
+        static const babelwires::BlockStream s_emptyStream;
+        return s_emptyStream;
+    }
+} // namespace
+
 bw_music::Track::Track() = default;
 
 bw_music::Track::Track(ModelDuration duration) {
@@ -16,40 +29,20 @@ bw_music::Track::Track(ModelDuration duration) {
 }
 
 int bw_music::Track::getNumEvents() const {
-    return m_blockStream.getNumEvents();
-}
-
-bw_music::Track::CachedValues::CachedValues(ModelDuration trackDuration)
-    : m_hash(trackDuration.getHash()) {}
-
-void bw_music::Track::CachedValues::addEvent(const TrackEvent& event) {
-    m_totalEventDuration += event.getTimeSinceLastEvent();
-    babelwires::hash::mixInto(m_hash, event.getHash());
-    TrackEvent::GroupingInfo groupingInfo = event.getGroupingInfo();
-    if ((groupingInfo.m_grouping == TrackEvent::GroupingInfo::Grouping::NotInGroup) ||
-        (groupingInfo.m_grouping == TrackEvent::GroupingInfo::Grouping::StartOfGroup)) {
-        ++m_numEventGroupsByCategory[groupingInfo.m_category];
-    }
-}
-
-void bw_music::Track::ensureCache() const {
-    if (!m_cacheIsValid) {
-        CachedValues newCache(getDuration());
-        for (const TrackEvent& event : *this) {
-            newCache.addEvent(event);
-        }
-        m_cachedValues = newCache;
-        m_cacheIsValid = true;
-    }
+    return m_numEvents;
 }
 
 bw_music::ModelDuration bw_music::Track::getDuration() const {
-    return m_duration;
+    const ModelDuration totalEventDuration = getTotalEventDuration();
+    return (totalEventDuration > m_duration) ? totalEventDuration : m_duration;
 }
 
 bw_music::ModelDuration bw_music::Track::getTotalEventDuration() const {
-    ensureCache();
-    return m_cachedValues.m_totalEventDuration;
+    return m_timebase.toModelDuration(m_totalEventTicks);
+}
+
+const bw_music::Timebase& bw_music::Track::getTimebase() const {
+    return m_timebase;
 }
 
 void bw_music::Track::setDuration(ModelDuration d) {
@@ -59,8 +52,10 @@ void bw_music::Track::setDuration(ModelDuration d) {
 }
 
 std::size_t bw_music::Track::getHash() const {
-    ensureCache();
-    return m_cachedValues.m_hash;
+    // The duration is only mixed in here, so the hashes of the segments stay independent of it.
+    std::size_t hash = m_hash;
+    babelwires::hash::mixInto(hash, getDuration().getHash());
+    return hash;
 }
 
 bool bw_music::Track::operator==(const Value& other) const {
@@ -71,7 +66,7 @@ bool bw_music::Track::operator==(const Value& other) const {
     if (otherTrack->getNumEvents() != getNumEvents()) {
         return false;
     }
-    if (otherTrack->m_duration != m_duration) {
+    if (otherTrack->getDuration() != getDuration()) {
         return false;
     }
     if (otherTrack->getHash() != getHash()) {
@@ -81,6 +76,21 @@ bool bw_music::Track::operator==(const Value& other) const {
     auto otherIt = otherTrack->begin();
     while (thisIt != end()) {
         assert(otherIt != otherTrack->end());
+        // When segments line up, they can often be compared without looking at their events.
+        if (thisIt.isAtStartOfSegment() && otherIt.isAtStartOfSegment()) {
+            const Segment& thisSegment = *thisIt.m_segment;
+            const Segment& otherSegment = *otherIt.m_segment;
+            if (thisSegment.m_events->getNumEvents() == otherSegment.m_events->getNumEvents()) {
+                if (thisSegment.m_events == otherSegment.m_events) {
+                    thisIt.advanceToNextSegment();
+                    otherIt.advanceToNextSegment();
+                    continue;
+                }
+                if (thisSegment.m_hash != otherSegment.m_hash) {
+                    return false;
+                }
+            }
+        }
         if (*thisIt != *otherIt) {
             return false;
         }
@@ -91,23 +101,164 @@ bool bw_music::Track::operator==(const Value& other) const {
     return true;
 }
 
+void bw_music::Track::addToTotalEventTicks(Timebase& timebase, Ticks& totalEventTicks, const TrackEvent& event) {
+    const ModelDuration timeSinceLastEvent = event.getTimeSinceLastEvent();
+    // Simultaneous events are common.
+    if (timeSinceLastEvent != 0) {
+        totalEventTicks *= timebase.extendToRepresent(timeSinceLastEvent);
+        totalEventTicks += timebase.toTicks(timeSinceLastEvent);
+    }
+}
+
+void bw_music::Track::addToSegmentHash(Segment& segment, std::size_t eventHash) {
+    segment.m_hash = segment.m_hash * c_hashBase + eventHash;
+    segment.m_hashMultiplier *= c_hashBase;
+}
+
+std::size_t bw_music::Track::computeHash() const {
+    std::size_t hash = c_initialHash;
+    for (const Segment& segment : m_segments) {
+        hash = hash * segment.m_hashMultiplier + segment.m_hash;
+    }
+    return hash;
+}
+
+bw_music::Track::Segment& bw_music::Track::getAppendableSegment() {
+    if (!m_segments.empty()) {
+        Segment& lastSegment = m_segments.back();
+        if ((lastSegment.m_events.use_count() == 1) &&
+            (lastSegment.m_events->getNumEvents() < c_maxEventsPerSegment)) {
+            // Another track may have just released the events, so synchronize with that before modifying them.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return lastSegment;
+        }
+    }
+    return m_segments.emplace_back(Segment{std::make_shared<babelwires::BlockStream>()});
+}
+
 void bw_music::Track::onNewEvent(const TrackEvent& event) {
-    ensureCache();
-    m_cachedValues.addEvent(event);
-    if (getTotalEventDuration() > m_duration) {
-        m_duration = getTotalEventDuration();
+    ++m_numEvents;
+    addToTotalEventTicks(m_timebase, m_totalEventTicks, event);
+    const std::size_t eventHash = event.getHash();
+    m_hash = m_hash * c_hashBase + eventHash;
+    addToSegmentHash(m_segments.back(), eventHash);
+    // If the summary has not been computed, it will include this event when it is.
+    if (auto* const numEventGroupsByCategory = m_numEventGroupsByCategory.tryGetMutable()) {
+        addToNumEventGroupsByCategory(*numEventGroupsByCategory, event);
+    }
+    if (auto* const eventSummary = m_eventSummary.tryGetMutable()) {
+        addToEventSummary(*eventSummary, event);
+    }
+    if (m_timeIndex.tryGetMutable()) {
+        m_timeIndex.reset();
     }
 }
 
 bw_music::Track::const_iterator bw_music::Track::end() const {
-    return m_blockStream.end_impl<TrackEvent>();
+    const Segment* const segmentsEnd = m_segments.data() + m_segments.size();
+    return const_iterator(segmentsEnd, segmentsEnd);
 }
 
 bw_music::Track::const_iterator bw_music::Track::begin() const {
-    return m_blockStream.begin_impl<TrackEvent>();
+    return const_iterator(m_segments.data(), m_segments.data() + m_segments.size());
+}
+
+bw_music::Track::const_iterator::const_iterator(const Segment* segment, const Segment* segmentsEnd)
+    : m_segment(segment)
+    , m_segmentsEnd(segmentsEnd)
+    , m_eventIterator(getStream(segment, segmentsEnd).begin_impl<TrackEvent>())
+    , m_segmentEnd(getStream(segment, segmentsEnd).end_impl<TrackEvent>()) {}
+
+void bw_music::Track::const_iterator::advanceToNextSegment() {
+    assert((m_segment != m_segmentsEnd) && "Cannot advance beyond the end of a track");
+    ++m_segment;
+    // Segments are never empty, so the iterator is now either at an event or at the end.
+    const babelwires::BlockStream& stream = getStream(m_segment, m_segmentsEnd);
+    m_eventIterator = stream.begin_impl<TrackEvent>();
+    m_segmentEnd = stream.end_impl<TrackEvent>();
+}
+
+const babelwires::BlockStream& bw_music::Track::const_iterator::getStream(const Segment* segment,
+                                                                         const Segment* segmentsEnd) {
+    return (segment != segmentsEnd) ? *segment->m_events : getEmptyStream();
+}
+
+bool bw_music::Track::const_iterator::isAtStartOfSegment() const {
+    return (m_segment != m_segmentsEnd) && (m_eventIterator == m_segment->m_events->begin_impl<TrackEvent>());
+}
+
+void bw_music::Track::addToNumEventGroupsByCategory(std::unordered_map<const char*, int>& numEventGroupsByCategory,
+                                                    const TrackEvent& event) {
+    const TrackEvent::GroupingInfo groupingInfo = event.getGroupingInfo();
+    if ((groupingInfo.m_grouping == TrackEvent::GroupingInfo::Grouping::NotInGroup) ||
+        (groupingInfo.m_grouping == TrackEvent::GroupingInfo::Grouping::StartOfGroup)) {
+        ++numEventGroupsByCategory[groupingInfo.m_category];
+    }
+}
+
+std::unordered_map<const char*, int> bw_music::Track::computeNumEventGroupsByCategory() const {
+    std::unordered_map<const char*, int> numEventGroupsByCategory;
+    for (const TrackEvent& event : *this) {
+        addToNumEventGroupsByCategory(numEventGroupsByCategory, event);
+    }
+    return numEventGroupsByCategory;
 }
 
 const std::unordered_map<const char*, int>& bw_music::Track::getNumEventGroupsByCategory() const {
-    ensureCache();
-    return m_cachedValues.m_numEventGroupsByCategory;
+    return m_numEventGroupsByCategory.get([this]() { return computeNumEventGroupsByCategory(); });
+}
+
+void bw_music::Track::addToEventSummary(EventSummary& eventSummary, const TrackEvent& event) {
+    ++eventSummary.m_numEventsByCategory[event.getGroupingInfo().m_category];
+    if (const PercussionEvent* const percussionEvent = event.as<PercussionEvent>()) {
+        eventSummary.m_percussionInstruments.insert(percussionEvent->getInstrument());
+    }
+}
+
+bw_music::Track::EventSummary bw_music::Track::computeEventSummary() const {
+    EventSummary eventSummary;
+    for (const TrackEvent& event : *this) {
+        addToEventSummary(eventSummary, event);
+    }
+    return eventSummary;
+}
+
+const bw_music::Track::EventSummary& bw_music::Track::getEventSummary() const {
+    return m_eventSummary.get([this]() { return computeEventSummary(); });
+}
+
+std::vector<bw_music::Track::TimeIndexEntry> bw_music::Track::computeTimeIndex() const {
+    std::vector<TimeIndexEntry> timeIndex;
+    timeIndex.reserve(m_segments.size());
+    Ticks time = 0;
+    std::set<Group> openGroups;
+    for (const Segment& segment : m_segments) {
+        timeIndex.emplace_back(TimeIndexEntry{m_timebase.toModelDuration(time), openGroups});
+        const auto endIt = segment.m_events->end_impl<TrackEvent>();
+        for (auto it = segment.m_events->begin_impl<TrackEvent>(); it != endIt; ++it) {
+            time += m_timebase.toTicks(it->getTimeSinceLastEvent());
+            const TrackEvent::GroupingInfo info = it->getGroupingInfo();
+            if (info.m_grouping == TrackEvent::GroupingInfo::Grouping::StartOfGroup) {
+                openGroups.insert(Group{info.m_category, info.m_groupValue});
+            } else if (info.m_grouping == TrackEvent::GroupingInfo::Grouping::EndOfGroup) {
+                openGroups.erase(Group{info.m_category, info.m_groupValue});
+            }
+        }
+    }
+    return timeIndex;
+}
+
+bw_music::Track::SeekPosition bw_music::Track::getSeekPositionBefore(ModelDuration time) const {
+    const std::vector<TimeIndexEntry>& timeIndex = m_timeIndex.get([this]() { return computeTimeIndex(); });
+    // The events in the segments before an entry whose time is before the given time all occur before it.
+    const auto entryIt = std::partition_point(timeIndex.begin(), timeIndex.end(), [time](const TimeIndexEntry& entry) {
+        return entry.m_timeBeforeSegment < time;
+    });
+    if (entryIt == timeIndex.begin()) {
+        return SeekPosition{begin(), 0, {}};
+    }
+    const std::size_t segmentIndex = std::distance(timeIndex.begin(), entryIt) - 1;
+    const Segment* const segmentsEnd = m_segments.data() + m_segments.size();
+    return SeekPosition{const_iterator(m_segments.data() + segmentIndex, segmentsEnd),
+                        timeIndex[segmentIndex].m_timeBeforeSegment, timeIndex[segmentIndex].m_openGroups};
 }
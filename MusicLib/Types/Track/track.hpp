@@ -8,20 +8,28 @@
 #pragma once
 
 #include <MusicLib/Types/Track/TrackEvents/trackEvent.hpp>
+#include <MusicLib/Types/Track/timebase.hpp>
+#include <MusicLib/Utilities/lazilyComputedValue.hpp>
 #include <MusicLib/musicTypes.hpp>
 
 #include <BabelWiresLib/TypeSystem/value.hpp>
 
+#include <Common/Identifiers/identifier.hpp>
 #include <Common/types.hpp>
 
 #include <cassert>
+#include <memory>
+#include <set>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace bw_music {
     /// A track carries a stream of TrackEvents.
     /// Tracks are not editable: they can be manipulated only using Processors and can be serialized/deserialized only
     /// using SourceFileFormats and TargetFileFormats formats.
+    /// The const methods are safe to call concurrently from several threads.
     class Track : public babelwires::Value {
       public:
         CLONEABLE(Track);
@@ -33,7 +41,7 @@ namespace bw_music {
         /// Add a TrackEvent by moving or copying it into the track.
         template <typename EVENT, typename = std::enable_if_t<std::is_convertible_v<EVENT&, const TrackEvent&>>>
         void addEvent(EVENT&& srcEvent) {
-            onNewEvent(m_blockStream.addEvent(std::forward<EVENT>(srcEvent)));
+            onNewEvent(getAppendableSegment().m_events->addEvent(std::forward<EVENT>(srcEvent)));
         };
 
         /// Get the total number of events in the track.
@@ -46,9 +54,13 @@ namespace bw_music {
         /// in which case, the operation is ignored.
         void setDuration(ModelDuration d);
 
-        /// Return the total duration of the events in the track (which may be smaller than m_duration).
+        /// Return the total duration of the events in the track (which may be smaller than the duration).
         ModelDuration getTotalEventDuration() const;
 
+        /// The coarsest timebase in which the times of all the events can be represented exactly.
+        /// Functions can use this to process the events using integer arithmetic.
+        const Timebase& getTimebase() const;
+
         /// Get a hash corresponding to the state of the track's contents
         std::size_t getHash() const override;
 
@@ -56,11 +68,33 @@ namespace bw_music {
         /// Note: This is unconcerned with how events are laid out in their streams.
         bool operator==(const Value& other) const override;
 
-        /// Get a summary of the track contents, by category.
+        /// Get a summary of the track contents, by category. This is computed on first request.
         const std::unordered_map<const char*, int>& getNumEventGroupsByCategory() const;
 
+        /// What consumers such as file writers need to know about the events before they traverse them.
+        struct EventSummary {
+            /// The number of events in each category.
+            std::unordered_map<TrackEvent::GroupingInfo::Category, int> m_numEventsByCategory;
+            /// The instruments used by the percussion events.
+            std::unordered_set<babelwires::ShortId> m_percussionInstruments;
+        };
+
+        /// Get a summary of the events, gathered in a single pass. This is computed on first request.
+        const EventSummary& getEventSummary() const;
+
+        /// Identifies a group of events within the track.
+        using Group = std::tuple<TrackEvent::GroupingInfo::Category, TrackEvent::GroupingInfo::GroupValue>;
+
+        /// A position from which a traversal can start, with the state reached by traversing up to it.
+        struct SeekPosition;
+
+        /// Get a position such that all the events before it occur strictly before the given time.
+        /// This uses an index which is computed on first request, so at most one segment of events
+        /// needs to be visited to reach the first event at the time.
+        SeekPosition getSeekPositionBefore(ModelDuration time) const;
+
       public:
-        using const_iterator = babelwires::BlockStream::Iterator<const babelwires::BlockStream, const TrackEvent>;
+        class const_iterator;
         const_iterator begin() const;
         const_iterator end() const;
 
@@ -69,36 +103,153 @@ namespace bw_music {
         // a span.
         // using iterator = bw_music::BlockStream::Iterator<bw_music::BlockStream, TrackEvent>;
       protected:
+        friend class TrackBuilder;
+
+        /// A segment is a run of consecutive events. Copies of a track share its events, and a TrackBuilder can
+        /// share the events of a segment of a source track, so they must not be modified once they are shared.
+        struct Segment {
+            std::shared_ptr<babelwires::BlockStream> m_events;
+
+            /// The hash of the events in the segment.
+            std::size_t m_hash = 0;
+
+            /// c_hashBase to the power of the number of events in the segment.
+            std::size_t m_hashMultiplier = 1;
+        };
+
+        /// A track's hash is a polynomial in the hashes of its events, so the hash of a sequence of segments can be
+        /// obtained from their hashes without revisiting their events.
+        static constexpr std::size_t c_hashBase = 0x100000001b3;
+
+        /// Include the hash of an event in the hash of the segment.
+        static void addToSegmentHash(Segment& segment, std::size_t eventHash);
+
+        /// Segments which a track fills itself are limited to this many events, so unchanged runs of events can be
+        /// shared at a useful granularity.
+        static constexpr int c_maxEventsPerSegment = 1024;
+
+        /// Get the segment into which the next event should be added, starting a new segment if the last one is
+        /// shared or full.
+        Segment& getAppendableSegment();
+
         /// Update the cached values.
         void onNewEvent(const TrackEvent& event);
 
-        /// Ensure the cached values are up-to-date.
-        /// TODO: This is not thread-safe and will be dangerous when we multithread the project.
-        /// TODO: Might be important to distinguish data which is only needed for the UI (e.g.
-        /// m_numEventGroupsByCategory) since the UI will probably remain single-threaded) from those needed for
-        /// processing (m_totalEventDuration and hash).
-        void ensureCache() const;
+        /// Add the time of the event to the total, refining the timebase if necessary.
+        static void addToTotalEventTicks(Timebase& timebase, Ticks& totalEventTicks, const TrackEvent& event);
+
+        /// Compute the hash of the track from the hashes of its segments.
+        std::size_t computeHash() const;
+
+        /// Compute the summary of the track contents.
+        std::unordered_map<const char*, int> computeNumEventGroupsByCategory() const;
+
+        /// Update the summary to reflect the addition of the event.
+        static void addToNumEventGroupsByCategory(std::unordered_map<const char*, int>& numEventGroupsByCategory,
+                                                  const TrackEvent& event);
+
+        /// Compute the summary of the events.
+        EventSummary computeEventSummary() const;
+
+        /// Update the summary to reflect the addition of the event.
+        static void addToEventSummary(EventSummary& eventSummary, const TrackEvent& event);
+
+        /// The state of the track at the start of a segment.
+        struct TimeIndexEntry {
+            /// The sum of the times of the events in earlier segments.
+            ModelDuration m_timeBeforeSegment;
+            /// The groups started but not ended by events in earlier segments.
+            std::set<Group> m_openGroups;
+        };
+
+        /// Compute an entry for each segment.
+        std::vector<TimeIndexEntry> computeTimeIndex() const;
 
       protected:
-        /// The track's events are stored in a BlockStream.
-        babelwires::BlockStream m_blockStream;
+        /// The track's events are stored in a sequence of non-empty segments.
+        std::vector<Segment> m_segments;
 
-        /// The length of the track.
-        /// May be longer than the events duration, but may not be shorter.
+        int m_numEvents = 0;
+
+        /// The length of the track, if it is longer than the total duration of the events.
         ModelDuration m_duration;
 
-        mutable struct CachedValues {
-            CachedValues(ModelDuration trackDuration);
-            void addEvent(const TrackEvent& event);
-            /// The total duration of the events in the track.
-            ModelDuration m_totalEventDuration = 0;
-            std::size_t m_hash = 0;
+        /// The total duration of the events in the track is kept in ticks of the timebase.
+        /// This and the hash are needed during processing, so they are kept up-to-date as events are added.
+        Timebase m_timebase;
+        Ticks m_totalEventTicks = 0;
 
-            /// A summary of information about the track.
-            std::unordered_map<const char*, int> m_numEventGroupsByCategory;
-        } m_cachedValues = CachedValues(0);
+        /// The hash of an empty track.
+        static constexpr std::size_t c_initialHash = 0x2b9feee2;
+
+        std::size_t m_hash = c_initialHash;
+
+        /// A summary of information about the track, which is only needed by the UI.
+        /// This is computed on demand and published atomically.
+        LazilyComputedValue<std::unordered_map<const char*, int>> m_numEventGroupsByCategory;
+
+        /// This is computed on demand and published atomically.
+        LazilyComputedValue<EventSummary> m_eventSummary;
+
+        /// Supports seeking. This is computed on demand and discarded if the track is modified.
+        LazilyComputedValue<std::vector<TimeIndexEntry>> m_timeIndex;
+    };
+
+    /// Iterates through the events of all the segments of a track.
+    class Track::const_iterator {
+      public:
+        using value_type = const TrackEvent;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const TrackEvent*;
+        using reference = const TrackEvent&;
+        using iterator_category = std::forward_iterator_tag;
+
+        const TrackEvent& operator*() const { return *m_eventIterator; }
+        const TrackEvent* operator->() const { return &*m_eventIterator; }
+
+        const_iterator& operator++() {
+            ++m_eventIterator;
+            if (m_eventIterator == m_segmentEnd) {
+                advanceToNextSegment();
+            }
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return (m_segment == other.m_segment) && (m_eventIterator == other.m_eventIterator);
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+      private:
+        friend class Track;
+        friend class TrackBuilder;
+
+        using EventIterator = babelwires::BlockStream::Iterator<const babelwires::BlockStream, const TrackEvent>;
+
+        /// Construct an iterator at the start of the given segment. segment can equal segmentsEnd.
+        const_iterator(const Segment* segment, const Segment* segmentsEnd);
+
+        /// Move to the start of the next segment, or to the end.
+        void advanceToNextSegment();
+
+        /// The stream of the segment, or an empty stream if segment is the end.
+        static const babelwires::BlockStream& getStream(const Segment* segment, const Segment* segmentsEnd);
+
+        /// Is this iterator at the first event of a segment?
+        bool isAtStartOfSegment() const;
+
+      private:
+        const Segment* m_segment;
+        const Segment* m_segmentsEnd;
+        EventIterator m_eventIterator;
+        EventIterator m_segmentEnd;
+    };
 
-        /// Are the values in the cache up-to-date, or do they need to be recalculated.
-        mutable bool m_cacheIsValid = true;
+    struct Track::SeekPosition {
+        const_iterator m_iterator;
+        /// The sum of the times of the events before m_iterator.
+        ModelDuration m_timeBeforeEvent;
+        /// The groups started but not ended by the events before m_iterator.
+        std::set<Group> m_openGroups;
     };
 } // namespace bw_music
@@ -0,0 +1,75 @@
+/**
+ * A TrackBuilder constructs a Track in one pass.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+
+bw_music::TrackBuilder::TrackBuilder() = default;
+
+void bw_music::TrackBuilder::onNewEvent(const TrackEvent& event) {
+    ++m_numEvents;
+    Track::addToTotalEventTicks(m_timebase, m_totalEventTicks, event);
+}
+
+void bw_music::TrackBuilder::passThroughEvent(const Track::const_iterator& it) {
+    if (m_passThroughRun && (it != m_passThroughRun->m_next)) {
+        flushPassThroughRun();
+    }
+    if (!m_passThroughRun) {
+        if (!it.isAtStartOfSegment()) {
+            addEvent(*it);
+            return;
+        }
+        m_passThroughRun.emplace(PassThroughRun{it, it});
+    }
+    onNewEvent(*it);
+    ++m_passThroughRun->m_next;
+    if (m_passThroughRun->m_next.m_segment != it.m_segment) {
+        // The whole segment has been passed through, so it can be shared along with its hash.
+        m_track.m_segments.emplace_back(*it.m_segment);
+        m_passThroughRun.reset();
+    }
+}
+
+void bw_music::TrackBuilder::flushPassThroughRun() {
+    // The events have already been counted by onNewEvent, but not hashed.
+    for (auto it = m_passThroughRun->m_begin; it != m_passThroughRun->m_next; ++it) {
+        Track::Segment& segment = m_track.getAppendableSegment();
+        Track::addToSegmentHash(segment, segment.m_events->addEvent(*it).getHash());
+    }
+    m_passThroughRun.reset();
+}
+
+int bw_music::TrackBuilder::getNumEvents() const {
+    return m_numEvents;
+}
+
+bw_music::ModelDuration bw_music::TrackBuilder::getDuration() const {
+    const ModelDuration totalEventDuration = getTotalEventDuration();
+    return (totalEventDuration > m_duration) ? totalEventDuration : m_duration;
+}
+
+void bw_music::TrackBuilder::setDuration(ModelDuration d) {
+    if (d > getTotalEventDuration()) {
+        m_duration = d;
+    }
+}
+
+bw_music::ModelDuration bw_music::TrackBuilder::getTotalEventDuration() const {
+    return m_timebase.toModelDuration(m_totalEventTicks);
+}
+
+bw_music::Track bw_music::TrackBuilder::finishAndGetTrack() {
+    if (m_passThroughRun) {
+        flushPassThroughRun();
+    }
+    m_track.m_numEvents = m_numEvents;
+    m_track.m_timebase = m_timebase;
+    m_track.m_totalEventTicks = m_totalEventTicks;
+    m_track.m_hash = m_track.computeHash();
+    m_track.m_duration = getDuration();
+    return std::move(m_track);
+}
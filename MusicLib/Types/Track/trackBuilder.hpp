@@ -0,0 +1,91 @@
+/**
+ * A TrackBuilder constructs a Track in one pass.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/Types/Track/track.hpp>
+
+#include <optional>
+
+namespace bw_music {
+    /// Builds a Track by appending events.
+    /// Unlike Track::addEvent, the track's own bookkeeping is not updated per event: it is set once when the track
+    /// is finished, and the duration is finalized at the same time. The hash of the track is computed from the
+    /// hashes of its segments at that point.
+    class TrackBuilder {
+      public:
+        TrackBuilder();
+
+        /// Add a TrackEvent by moving or copying it into the track.
+        template <typename EVENT, typename = std::enable_if_t<std::is_convertible_v<EVENT&, const TrackEvent&>>>
+        void addEvent(EVENT&& srcEvent) {
+            if (m_passThroughRun) {
+                flushPassThroughRun();
+            }
+            Track::Segment& segment = m_track.getAppendableSegment();
+            const TrackEvent& newEvent = segment.m_events->addEvent(std::forward<EVENT>(srcEvent));
+            onNewEvent(newEvent);
+            Track::addToSegmentHash(segment, newEvent.getHash());
+        };
+
+        /// Add the event at the iterator without modifying it.
+        /// When consecutive calls pass through all the events of one of the source track's segments, that segment
+        /// is shared by the new track instead of being copied, and its hash is reused.
+        /// The source track must not be modified or destroyed until the track is finished.
+        void passThroughEvent(const Track::const_iterator& it);
+
+        /// Copy the events in the range into the track.
+        template <typename ITERATOR> void appendRange(ITERATOR begin, ITERATOR end) {
+            for (auto it = begin; it != end; ++it) {
+                addEvent(*it);
+            }
+        }
+
+        /// Get the number of events added so far.
+        int getNumEvents() const;
+
+        /// The duration the track would have if it was finished now.
+        ModelDuration getDuration() const;
+
+        /// Sets the track to have the given duration, unless that is shorter than the total duration of the events,
+        /// in which case, the operation is ignored. This has the same meaning as Track::setDuration.
+        void setDuration(ModelDuration d);
+
+        /// The total duration of the events added so far.
+        ModelDuration getTotalEventDuration() const;
+
+        /// Get the track. The builder should not be used afterwards.
+        Track finishAndGetTrack();
+
+      private:
+        /// Update the values which are tracked per event.
+        void onNewEvent(const TrackEvent& event);
+
+        /// Copy the events of an incomplete pass-through run into the track.
+        void flushPassThroughRun();
+
+      private:
+        /// The track under construction. Its bookkeeping is not valid until the track is finished.
+        Track m_track;
+
+        /// The duration requested by setDuration.
+        ModelDuration m_duration;
+
+        Timebase m_timebase;
+        Ticks m_totalEventTicks = 0;
+
+        int m_numEvents = 0;
+
+        /// Consecutive events passed through from the start of a segment of the source track, which have not yet
+        /// been added to the track.
+        struct PassThroughRun {
+            Track::const_iterator m_begin;
+            Track::const_iterator m_next;
+        };
+        std::optional<PassThroughRun> m_passThroughRun;
+    };
+} // namespace bw_music
@@ -0,0 +1,41 @@
+/**
+ * A LazilyComputedValue holds a value which is computed on first request and then shared by all readers.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <atomic>
+
+namespace bw_music {
+    /// Holds a value which is computed on demand and published atomically, so const access is lock-free and safe
+    /// from many threads. If several threads race to compute the value, exactly one result is published and the
+    /// others are discarded, so the computation must be deterministic.
+    /// As usual for values, the non-const methods must not be called concurrently with any other method.
+    template <typename T> class LazilyComputedValue {
+      public:
+        LazilyComputedValue() = default;
+        /// Copies carry the value if it has already been computed.
+        LazilyComputedValue(const LazilyComputedValue& other);
+        LazilyComputedValue(LazilyComputedValue&& other) noexcept;
+        LazilyComputedValue& operator=(const LazilyComputedValue& other);
+        LazilyComputedValue& operator=(LazilyComputedValue&& other) noexcept;
+        ~LazilyComputedValue();
+
+        /// Get the value, calling computeValue() to obtain it if it has not been published yet.
+        template <typename COMPUTE_VALUE> const T& get(COMPUTE_VALUE&& computeValue) const;
+
+        /// Get mutable access to the value if it has been computed, or nullptr otherwise.
+        T* tryGetMutable();
+
+        /// Discard the value, so it will be recomputed when next requested.
+        void reset();
+
+      private:
+        mutable std::atomic<T*> m_value = nullptr;
+    };
+} // namespace bw_music
+
+#include <MusicLib/Utilities/lazilyComputedValue_inl.hpp>
@@ -0,0 +1,63 @@
+/**
+ * A LazilyComputedValue holds a value which is computed on first request and then shared by all readers.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <memory>
+
+template <typename T>
+bw_music::LazilyComputedValue<T>::LazilyComputedValue(const LazilyComputedValue& other) {
+    const T* const otherValue = other.m_value.load(std::memory_order_acquire);
+    m_value.store(otherValue ? new T(*otherValue) : nullptr, std::memory_order_relaxed);
+}
+
+template <typename T>
+bw_music::LazilyComputedValue<T>::LazilyComputedValue(LazilyComputedValue&& other) noexcept {
+    m_value.store(other.m_value.exchange(nullptr, std::memory_order_acq_rel), std::memory_order_relaxed);
+}
+
+template <typename T>
+bw_music::LazilyComputedValue<T>& bw_music::LazilyComputedValue<T>::operator=(const LazilyComputedValue& other) {
+    if (this != &other) {
+        const T* const otherValue = other.m_value.load(std::memory_order_acquire);
+        delete m_value.exchange(otherValue ? new T(*otherValue) : nullptr, std::memory_order_acq_rel);
+    }
+    return *this;
+}
+
+template <typename T>
+bw_music::LazilyComputedValue<T>& bw_music::LazilyComputedValue<T>::operator=(LazilyComputedValue&& other) noexcept {
+    if (this != &other) {
+        delete m_value.exchange(other.m_value.exchange(nullptr, std::memory_order_acq_rel), std::memory_order_acq_rel);
+    }
+    return *this;
+}
+
+template <typename T> bw_music::LazilyComputedValue<T>::~LazilyComputedValue() {
+    delete m_value.load(std::memory_order_acquire);
+}
+
+template <typename T>
+template <typename COMPUTE_VALUE>
+const T& bw_music::LazilyComputedValue<T>::get(COMPUTE_VALUE&& computeValue) const {
+    T* currentValue = m_value.load(std::memory_order_acquire);
+    if (!currentValue) {
+        auto newValue = std::make_unique<T>(computeValue());
+        // On failure, currentValue receives the value published by another thread and ours is discarded.
+        if (m_value.compare_exchange_strong(currentValue, newValue.get(), std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+            currentValue = newValue.release();
+        }
+    }
+    return *currentValue;
+}
+
+template <typename T> T* bw_music::LazilyComputedValue<T>::tryGetMutable() {
+    return m_value.load(std::memory_order_acquire);
+}
+
+template <typename T> void bw_music::LazilyComputedValue<T>::reset() {
+    delete m_value.exchange(nullptr, std::memory_order_acq_rel);
+}
@@ -0,0 +1,36 @@
+/**
+ * The MergingTraverser visits the events of several tracks in time order.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Utilities/mergingTraverser.hpp>
+
+bw_music::MergingTraverser::MergingTraverser(const std::vector<const Track*>& tracks) {
+    const int numTracks = tracks.size();
+    m_cursors.reserve(numTracks);
+    m_heap.reserve(numTracks);
+    for (const Track* track : tracks) {
+        m_timebase.extendToRepresent(track->getTimebase());
+        if (track->getDuration() > m_duration) {
+            m_duration = track->getDuration();
+        }
+    }
+    for (int i = 0; i < numTracks; ++i) {
+        const Track& track = *tracks[i];
+        m_cursors.emplace_back(TrackCursor{track.begin(), track.end()});
+        if (track.getNumEvents() > 0) {
+            m_heap.emplace_back(HeapEntry{m_timebase.toTicks(track.begin()->getTimeSinceLastEvent()), i});
+        }
+    }
+    std::make_heap(m_heap.begin(), m_heap.end());
+}
+
+const bw_music::Timebase& bw_music::MergingTraverser::getTimebase() const {
+    return m_timebase;
+}
+
+bw_music::ModelDuration bw_music::MergingTraverser::getDuration() const {
+    return m_duration;
+}
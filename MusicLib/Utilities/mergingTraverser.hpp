@@ -0,0 +1,62 @@
+/**
+ * The MergingTraverser visits the events of several tracks in time order.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/Types/Track/track.hpp>
+
+#include <vector>
+
+namespace bw_music {
+    /// Visits the events of several tracks in time order, as required when multiplexing tracks together.
+    /// Events at the same time are visited in the order of their tracks, with all the events of one track at that
+    /// time visited together.
+    /// The pending tracks are kept in a heap keyed on the absolute time of their next event, so the cost per
+    /// event is logarithmic in the number of tracks. Times are handled as ticks of a common timebase.
+    class MergingTraverser {
+      public:
+        /// The tracks must outlive the traverser.
+        MergingTraverser(const std::vector<const Track*>& tracks);
+
+        /// A timebase which can represent the times of all events in all the tracks.
+        const Timebase& getTimebase() const;
+
+        /// The maximum duration of the tracks.
+        ModelDuration getDuration() const;
+
+        /// Call the visitor at every event, in order. The visitor is called with the index of the event's track, the
+        /// time of the event since the start in ticks of the timebase, and an iterator at the event.
+        template <typename VISITOR> void visitEvents(VISITOR&& visitor);
+
+      private:
+        /// The state of one of the tracks.
+        struct TrackCursor {
+            Track::const_iterator m_iterator;
+            Track::const_iterator m_end;
+        };
+
+        /// An entry for a track which has events left, ordered for use in a min-heap.
+        struct HeapEntry {
+            /// The time of the next event of the track.
+            Ticks m_time;
+            int m_trackIndex;
+
+            /// std::make_heap builds a max-heap, so this reverses the order.
+            bool operator<(const HeapEntry& other) const {
+                return (m_time > other.m_time) || ((m_time == other.m_time) && (m_trackIndex > other.m_trackIndex));
+            }
+        };
+
+      private:
+        Timebase m_timebase;
+        ModelDuration m_duration;
+        std::vector<TrackCursor> m_cursors;
+        std::vector<HeapEntry> m_heap;
+    };
+} // namespace bw_music
+
+#include <MusicLib/Utilities/mergingTraverser_inl.hpp>
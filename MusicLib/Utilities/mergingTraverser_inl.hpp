@@ -0,0 +1,26 @@
+/**
+ * The MergingTraverser visits the events of several tracks in time order.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <algorithm>
+
+template <typename VISITOR> void bw_music::MergingTraverser::visitEvents(VISITOR&& visitor) {
+    while (!m_heap.empty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end());
+        HeapEntry& entry = m_heap.back();
+        TrackCursor& cursor = m_cursors[entry.m_trackIndex];
+        do {
+            visitor(entry.m_trackIndex, entry.m_time, cursor.m_iterator);
+            ++cursor.m_iterator;
+        } while ((cursor.m_iterator != cursor.m_end) && (cursor.m_iterator->getTimeSinceLastEvent() == 0));
+        if (cursor.m_iterator != cursor.m_end) {
+            entry.m_time += m_timebase.toTicks(cursor.m_iterator->getTimeSinceLastEvent());
+            std::push_heap(m_heap.begin(), m_heap.end());
+        } else {
+            m_heap.pop_back();
+        }
+    }
+}
@@ -10,11 +10,5 @@
 #include <MusicLib/Types/Track/track.hpp>
 
 int bw_music::getMinimumDenominator(const Track& track) {
-    int denominator = 1;
-
-    for (const auto& e : track) {
-        denominator = babelwires::lcm(denominator, e.getTimeSinceLastEvent().getDenominator());
-    }
-
-    return denominator;
+    return track.getTimebase().getTicksPerWholeNote();
 }
@@ -0,0 +1,19 @@
+/**
+ * Run the iterations of a loop on several threads.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <cstddef>
+
+namespace bw_music {
+    /// Call f(i) for each i in [0, n), using up to maxThreads threads. Zero means use the available hardware threads.
+    /// The calling thread does some of the work. If any calls throw, the exception from the lowest index is rethrown,
+    /// so the outcome does not depend on the scheduling. If a thread cannot be started, fewer threads are used.
+    template <typename FUNC> void parallelFor(std::size_t n, unsigned int maxThreads, FUNC&& f);
+} // namespace bw_music
+
+#include <MusicLib/Utilities/parallelFor_inl.hpp>
@@ -0,0 +1,55 @@
+/**
+ * Run the iterations of a loop on several threads.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+template <typename FUNC> void bw_music::parallelFor(std::size_t n, unsigned int maxThreads, FUNC&& f) {
+    if (maxThreads == 0) {
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    const std::size_t numThreads = std::min<std::size_t>(n, maxThreads);
+    if (numThreads <= 1) {
+        for (std::size_t i = 0; i < n; ++i) {
+            f(i);
+        }
+        return;
+    }
+    std::atomic<std::size_t> nextIndex = 0;
+    std::vector<std::exception_ptr> exceptions(n);
+    auto worker = [n, &f, &nextIndex, &exceptions]() {
+        for (std::size_t i = nextIndex++; i < n; i = nextIndex++) {
+            try {
+                f(i);
+            } catch (...) {
+                exceptions[i] = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    try {
+        for (std::size_t t = 1; t < numThreads; ++t) {
+            threads.emplace_back(worker);
+        }
+    } catch (const std::system_error&) {
+        // A thread could not be started. The threads which did start share the work with the calling thread.
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+}
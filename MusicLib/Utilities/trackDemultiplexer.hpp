@@ -0,0 +1,25 @@
+/**
+ * Route the events of a track to several output tracks in a single traversal.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/Types/Track/track.hpp>
+
+#include <vector>
+
+namespace bw_music {
+    /// Route each event of the source track to one of numOutputs output tracks, in a single traversal.
+    /// The classifier is called with each event and returns the index of the output which should receive it, or -1
+    /// if the event should be dropped. Each event keeps its time, so its delta is measured from the previous event
+    /// in the same output. Every output has the duration of the source track.
+    /// Events whose delta does not change are passed through, so runs of events which all go to the same output
+    /// are shared with the source track.
+    template <typename CLASSIFIER>
+    std::vector<Track> demultiplexTrack(const Track& sourceTrack, int numOutputs, CLASSIFIER&& classifier);
+} // namespace bw_music
+
+#include <MusicLib/Utilities/trackDemultiplexer_inl.hpp>
@@ -0,0 +1,50 @@
+/**
+ * Route the events of a track to several output tracks in a single traversal.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+
+#include <cassert>
+
+template <typename CLASSIFIER>
+std::vector<bw_music::Track> bw_music::demultiplexTrack(const Track& sourceTrack, int numOutputs,
+                                                        CLASSIFIER&& classifier) {
+    const Timebase& timebase = sourceTrack.getTimebase();
+    std::vector<TrackBuilder> builders(numOutputs);
+    // The time of the last event routed to each output.
+    std::vector<Ticks> timeOfLastEvent(numOutputs, 0);
+
+    Ticks time = 0;
+    for (auto it = sourceTrack.begin(); it != sourceTrack.end(); ++it) {
+        const Ticks timeOfPreviousEvent = time;
+        const ModelDuration timeSinceLastEvent = it->getTimeSinceLastEvent();
+        if (timeSinceLastEvent != 0) {
+            time += timebase.toTicks(timeSinceLastEvent);
+        }
+        const int outputIndex = classifier(*it);
+        if (outputIndex < 0) {
+            continue;
+        }
+        assert((outputIndex < numOutputs) && "The classifier returned an index out of range");
+        if (timeOfLastEvent[outputIndex] == timeOfPreviousEvent) {
+            builders[outputIndex].passThroughEvent(it);
+        } else {
+            TrackEventHolder newEvent = *it;
+            newEvent->setTimeSinceLastEvent(timebase.toModelDuration(time - timeOfLastEvent[outputIndex]));
+            builders[outputIndex].addEvent(newEvent.release());
+        }
+        timeOfLastEvent[outputIndex] = time;
+    }
+
+    std::vector<Track> outputs;
+    outputs.reserve(numOutputs);
+    for (auto& builder : builders) {
+        builder.setDuration(sourceTrack.getDuration());
+        outputs.emplace_back(builder.finishAndGetTrack());
+    }
+    return outputs;
+}
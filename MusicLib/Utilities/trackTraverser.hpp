@@ -10,8 +10,6 @@
 #include <Common/BlockStream/streamEventHolder.hpp>
 #include <MusicLib/Types/Track/track.hpp>
 
-#include <functional>
-
 namespace bw_music {
 
     /// This class aids the traversal of a track in time chunks which may lie between events.
@@ -32,8 +30,9 @@ namespace bw_music {
         /// Advance the traverser and call the visitor at any events that occur at the new time.
         /// The events may be temporary, so the visitor should not try to store a pointer to them.
         /// time must not exceed the value limited by greatestLowerBoundNextEvent().
-        void advance(ModelDuration time,
-                     const std::function<void(const typename TRACK_ITERATOR::value_type&)>& eventVisitor);
+        /// The visitor is called with a const value_type&. Taking it as a template parameter allows the call to be
+        /// inlined.
+        template <typename VISITOR> void advance(ModelDuration time, VISITOR&& eventVisitor);
 
         /// A vector of events.
         using EventsAtTime = std::vector<babelwires::StreamEventHolder<typename TRACK_ITERATOR::value_type>>;
@@ -36,8 +36,8 @@ void bw_music::TrackTraverser<TRACK_ITERATOR>::greatestLowerBoundNextEvent(Model
 }
 
 template <typename TRACK_ITERATOR>
-void bw_music::TrackTraverser<TRACK_ITERATOR>::advance(
-    ModelDuration time, const std::function<void(const typename TRACK_ITERATOR::value_type&)>& eventVisitor) {
+template <typename VISITOR>
+void bw_music::TrackTraverser<TRACK_ITERATOR>::advance(ModelDuration time, VISITOR&& eventVisitor) {
     if (m_iterator != m_endIterator) {
         assert((time <= m_timeToNextEvent) && "You cannot advance beyond the next event");
         m_timeToNextEvent -= time;
@@ -22,6 +22,7 @@
 #include <MusicLib/Processors/repeatProcessor.hpp>
 #include <MusicLib/Processors/silenceProcessor.hpp>
 #include <MusicLib/Processors/splitAtPitchProcessor.hpp>
+#include <MusicLib/Processors/splitByCategoryProcessor.hpp>
 #include <MusicLib/Processors/transposeProcessor.hpp>
 #include <MusicLib/Types/Track/trackTypeConstructor.hpp>
 #include <MusicLib/Types/tempo.hpp>
@@ -48,6 +49,10 @@ void bw_music::registerLib(babelwires::ProjectContext& context) {
     context.m_typeSystem.addEntry<SplitAtPitchProcessorOutput>();
     context.m_processorReg.addProcessor<SplitAtPitchProcessor>();
 
+    context.m_typeSystem.addEntry<SplitByCategoryProcessorInput>();
+    context.m_typeSystem.addEntry<SplitByCategoryProcessorOutput>();
+    context.m_processorReg.addProcessor<SplitByCategoryProcessor>();
+
     context.m_typeSystem.addEntry<MonophonicSubtracksPolicyEnum>();
     context.m_typeSystem.addEntry<MonophonicSubtracksProcessorInput>();
     context.m_typeSystem.addEntry<MonophonicSubtracksProcessorOutput>();
@@ -0,0 +1,31 @@
+#include <Plugins/Smf/Benchmarks/allocationCounter.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<std::size_t> s_numAllocations = 0;
+} // namespace
+
+std::size_t smfBenchmarkUtils::getNumAllocations() {
+    return s_numAllocations.load(std::memory_order_relaxed);
+}
+
+// The other forms of operator new and delete are implemented by the standard library in terms of these.
+
+void* operator new(std::size_t size) {
+    s_numAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* const ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+
+namespace smfBenchmarkUtils {
+    /// The number of calls to the global operator new since the program started.
+    /// The benchmark executable replaces operator new to count them.
+    std::size_t getNumAllocations();
+} // namespace smfBenchmarkUtils
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <Plugins/Smf/Benchmarks/allocationCounter.hpp>
+#include <Plugins/Smf/Benchmarks/syntheticSmf.hpp>
+#include <Plugins/Smf/Plugin/libRegistration.hpp>
+#include <Plugins/Smf/Plugin/smfParser.hpp>
+#include <Plugins/Smf/Plugin/smfWriter.hpp>
+
+#include <Benchmarks/MusicLib/musicLibEnvironment.hpp>
+
+#include <BabelWiresLib/ValueTree/valueTreeRoot.hpp>
+
+#include <sstream>
+
+namespace {
+    /// The SMF types are registered on top of the MusicLib ones.
+    struct SmfEnvironment : benchmarkUtils::MusicLibEnvironment {
+        SmfEnvironment() { smf::registerLib(m_projectContext); }
+    };
+
+    /// Report events/s, allocations per event and, through the bytes, MB/s.
+    void setCounters(benchmark::State& state, std::size_t numBytes, int numEvents, std::size_t numAllocations) {
+        state.SetBytesProcessed(state.iterations() * numBytes);
+        state.SetItemsProcessed(state.iterations() * numEvents);
+        state.counters["allocs_per_event"] =
+            static_cast<double>(numAllocations) / (static_cast<double>(state.iterations()) * numEvents);
+    }
+} // namespace
+
+/// Arguments: The number of tracks, and the number of notes in each.
+static void BM_parseSmf(benchmark::State& state) {
+    SmfEnvironment environment;
+    const smfBenchmarkUtils::SyntheticSmf smf = smfBenchmarkUtils::makeSyntheticSmf(state.range(0), state.range(1));
+
+    const std::size_t allocationsBefore = smfBenchmarkUtils::getNumAllocations();
+    for (auto _ : state) {
+        auto result = smf::parseSmfSequence(smf.m_data, environment.m_projectContext, environment.m_log);
+        benchmark::DoNotOptimize(result);
+    }
+    setCounters(state, smf.m_data.size(), smf.m_numEvents,
+                smfBenchmarkUtils::getNumAllocations() - allocationsBefore);
+}
+// The tracks of format 1 files are built on several threads, so wall-clock time is the meaningful measure.
+BENCHMARK(BM_parseSmf)
+    ->Args({1, 1 << 16})
+    ->Args({16, 1 << 12})
+    ->Args({64, 1 << 12})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/// Arguments: The PercussionSpec, the number of tracks, and the number of notes in each.
+/// Every note is a percussion note, so this measures the conversion between pitches and instruments.
+static void BM_parsePercussionSmf(benchmark::State& state) {
+    SmfEnvironment environment;
+    const smfBenchmarkUtils::SyntheticSmf smf = smfBenchmarkUtils::makeSyntheticPercussionSmf(
+        static_cast<smfBenchmarkUtils::PercussionSpec>(state.range(0)), state.range(1), state.range(2));
+
+    const std::size_t allocationsBefore = smfBenchmarkUtils::getNumAllocations();
+    for (auto _ : state) {
+        auto result = smf::parseSmfSequence(smf.m_data, environment.m_projectContext, environment.m_log);
+        benchmark::DoNotOptimize(result);
+    }
+    setCounters(state, smf.m_data.size(), smf.m_numEvents,
+                smfBenchmarkUtils::getNumAllocations() - allocationsBefore);
+}
+BENCHMARK(BM_parsePercussionSmf)
+    ->ArgsProduct({{static_cast<int>(smfBenchmarkUtils::PercussionSpec::GM),
+                    static_cast<int>(smfBenchmarkUtils::PercussionSpec::GS),
+                    static_cast<int>(smfBenchmarkUtils::PercussionSpec::XG)},
+                   {1, 8},
+                   {1 << 14}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/// Arguments: The number of tracks, the number of notes in each, and whether to use running status.
+/// The bytes and events are those of the written file and of the file it was parsed from, respectively.
+static void BM_writeSmf(benchmark::State& state) {
+    SmfEnvironment environment;
+    const smfBenchmarkUtils::SyntheticSmf smf = smfBenchmarkUtils::makeSyntheticSmf(state.range(0), state.range(1));
+    const auto sequence = smf::parseSmfSequence(smf.m_data, environment.m_projectContext, environment.m_log);
+
+    std::size_t numBytesWritten = 0;
+    const std::size_t allocationsBefore = smfBenchmarkUtils::getNumAllocations();
+    for (auto _ : state) {
+        std::ostringstream output;
+        smf::SmfWriter writer(environment.m_projectContext, environment.m_log, *sequence, output);
+        writer.setUseRunningStatus(state.range(2));
+        writer.write();
+        numBytesWritten = output.tellp();
+        benchmark::DoNotOptimize(numBytesWritten);
+    }
+    setCounters(state, numBytesWritten, smf.m_numEvents, smfBenchmarkUtils::getNumAllocations() - allocationsBefore);
+    state.counters["bytes_per_event"] = static_cast<double>(numBytesWritten) / smf.m_numEvents;
+}
+BENCHMARK(BM_writeSmf)
+    ->ArgsProduct({{1}, {1 << 16}, {0, 1}})
+    ->ArgsProduct({{16, 64}, {1 << 12}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,16 @@
+#include <benchmark/benchmark.h>
+
+#include <Common/Identifiers/identifierRegistry.hpp>
+
+int main(int argc, char** argv) {
+    // The SMF types use the BW_SHORT_ID macros, so they have to work within the same registry singleton.
+    babelwires::IdentifierRegistryScope identifierRegistry;
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
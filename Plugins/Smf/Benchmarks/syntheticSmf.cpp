@@ -0,0 +1,238 @@
+#include <Plugins/Smf/Benchmarks/syntheticSmf.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace {
+    class SmfBuilder {
+      public:
+        SmfBuilder(smfBenchmarkUtils::SyntheticSmf& smf)
+            : m_data(smf.m_data)
+            , m_numEvents(smf.m_numEvents) {}
+
+        void writeBytes(std::string_view bytes) { m_data.insert(m_data.end(), bytes.begin(), bytes.end()); }
+
+        void writeByte(babelwires::Byte byte) { m_data.emplace_back(byte); }
+
+        void writeU16(std::uint16_t value) {
+            writeByte(value >> 8);
+            writeByte(value & 0xFF);
+        }
+
+        void writeU32(std::uint32_t value) {
+            writeU16(value >> 16);
+            writeU16(value & 0xFFFF);
+        }
+
+        void writeVariableLengthQuantity(std::uint32_t value) {
+            for (int shift = 21; shift > 0; shift -= 7) {
+                if (value >= (1u << shift)) {
+                    writeByte(0x80 | ((value >> shift) & 0x7F));
+                }
+            }
+            writeByte(value & 0x7F);
+        }
+
+        void beginTrack() {
+            writeBytes("MTrk");
+            m_trackLengthPosition = m_data.size();
+            writeU32(0);
+            m_runningStatus = 0;
+        }
+
+        void endTrack() {
+            writeMetaEvent(0, 0x2F, "");
+            const std::uint32_t length = m_data.size() - m_trackLengthPosition - 4;
+            for (int i = 0; i < 4; ++i) {
+                m_data[m_trackLengthPosition + i] = (length >> (24 - 8 * i)) & 0xFF;
+            }
+        }
+
+        void writeMetaEvent(std::uint32_t delta, babelwires::Byte type, std::string_view contents) {
+            writeVariableLengthQuantity(delta);
+            writeByte(0xFF);
+            writeByte(type);
+            writeVariableLengthQuantity(contents.size());
+            writeBytes(contents);
+            m_runningStatus = 0;
+            ++m_numEvents;
+        }
+
+        /// The contents should not include the initial F0, but should include the terminating F7.
+        void writeSysExEvent(std::uint32_t delta, std::string_view contents) {
+            writeVariableLengthQuantity(delta);
+            writeByte(0xF0);
+            writeVariableLengthQuantity(contents.size());
+            writeBytes(contents);
+            m_runningStatus = 0;
+            ++m_numEvents;
+        }
+
+        /// The status byte is omitted when running status allows it.
+        void writeChannelEvent(std::uint32_t delta, babelwires::Byte status, babelwires::Byte data0) {
+            writeVariableLengthQuantity(delta);
+            if (status != m_runningStatus) {
+                writeByte(status);
+                m_runningStatus = status;
+            }
+            writeByte(data0);
+            ++m_numEvents;
+        }
+
+        void writeChannelEvent(std::uint32_t delta, babelwires::Byte status, babelwires::Byte data0,
+                               babelwires::Byte data1) {
+            writeChannelEvent(delta, status, data0);
+            writeByte(data1);
+        }
+
+      private:
+        std::vector<babelwires::Byte>& m_data;
+        int& m_numEvents;
+        std::size_t m_trackLengthPosition = 0;
+        babelwires::Byte m_runningStatus = 0;
+    };
+
+    constexpr std::uint16_t s_division = 480;
+
+    using namespace std::literals;
+
+    // General MIDI System On.
+    constexpr std::string_view s_gmSystemOn = "\x7E\x7F\x09\x01\xF7"sv;
+    // Roland GS Reset.
+    constexpr std::string_view s_gsReset = "\x41\x10\x42\x12\x40\x00\x7F\x00\x41\xF7"sv;
+    // Yamaha XG System On.
+    constexpr std::string_view s_xgSystemOn = "\x43\x10\x4C\x00\x00\x7E\x00\xF7"sv;
+
+    /// Write the header chunk of a format 1 file.
+    void writeHeader(SmfBuilder& builder, int numTracks) {
+        builder.writeBytes("MThd");
+        builder.writeU32(6);
+        builder.writeU16(1);
+        builder.writeU16(numTracks);
+        builder.writeU16(s_division);
+    }
+
+    /// Start the conductor track, leaving it open for further setup events.
+    void beginConductorTrack(SmfBuilder& builder) {
+        builder.beginTrack();
+        builder.writeMetaEvent(0, 0x03, "Synthetic benchmark sequence");
+        builder.writeMetaEvent(0, 0x02, "No rights reserved");
+        builder.writeMetaEvent(0, 0x58, "\x04\x02\x18\x08"sv);
+        builder.writeMetaEvent(0, 0x51, "\x07\xA1\x20"sv);
+    }
+
+    /// Write the bar markers and close the conductor track.
+    void endConductorTrack(SmfBuilder& builder, int numBars) {
+        for (int bar = 0; bar < numBars; ++bar) {
+            builder.writeMetaEvent((bar == 0) ? 0 : s_division * 4, 0x06, "Bar " + std::to_string(bar + 1));
+        }
+        builder.endTrack();
+    }
+
+    void writeConductorTrack(SmfBuilder& builder, int numBars) {
+        beginConductorTrack(builder);
+        builder.writeSysExEvent(0, s_gmSystemOn);
+        builder.writeSysExEvent(0, s_gsReset);
+        endConductorTrack(builder, numBars);
+    }
+
+    void writeNoteTrack(SmfBuilder& builder, int trackIndex, int numNotes) {
+        const babelwires::Byte channel = trackIndex % 16;
+        const bool isPercussion = (channel == 9);
+        const babelwires::Byte noteOn = 0x90 | channel;
+        const babelwires::Byte controlChange = 0xB0 | channel;
+
+        builder.beginTrack();
+        builder.writeMetaEvent(0, 0x03, "Track " + std::to_string(trackIndex));
+        builder.writeChannelEvent(0, controlChange, 0x00, 0x00);
+        builder.writeChannelEvent(0, 0xC0 | channel, trackIndex % 128);
+        builder.writeChannelEvent(0, controlChange, 0x07, 100);
+
+        for (int pair = 0; pair < numNotes / 2; ++pair) {
+            if ((pair % 32) == 31) {
+                // Interrupt the running status.
+                builder.writeChannelEvent(0, controlChange, 0x0B, 64 + (pair % 64));
+            }
+            // GM percussion covers pitches 35 to 81.
+            const babelwires::Byte lowPitch =
+                isPercussion ? (35 + (pair % 23)) : (36 + ((pair * 5 + trackIndex) % 36));
+            const babelwires::Byte highPitch = isPercussion ? (58 + (pair % 24)) : (lowPitch + 12 + (pair % 12));
+            const std::uint32_t gap = (pair % 3 == 2) ? s_division / 2 : 0;
+            const std::uint32_t length = (pair % 2) ? s_division / 4 : s_division / 2;
+            const babelwires::Byte velocity = 64 + (pair % 63);
+            builder.writeChannelEvent(gap, noteOn, lowPitch, velocity);
+            builder.writeChannelEvent(0, noteOn, highPitch, velocity);
+            builder.writeChannelEvent(length, noteOn, lowPitch, 0);
+            builder.writeChannelEvent(0, noteOn, highPitch, 0);
+        }
+        builder.endTrack();
+    }
+
+    void writePercussionTrack(SmfBuilder& builder, int trackIndex, int numNotes) {
+        const babelwires::Byte noteOn = 0x99;
+
+        builder.beginTrack();
+        builder.writeMetaEvent(0, 0x03, "Percussion " + std::to_string(trackIndex));
+        for (int pair = 0; pair < numNotes / 2; ++pair) {
+            // Pitches 25 to 89 extend a little beyond the GS and XG kits, and well beyond GM percussion.
+            const babelwires::Byte lowPitch = 25 + ((pair * 7 + trackIndex) % 32);
+            const babelwires::Byte highPitch = lowPitch + 33;
+            const std::uint32_t gap = (pair % 4 == 3) ? s_division / 4 : 0;
+            const babelwires::Byte velocity = 64 + (pair % 63);
+            builder.writeChannelEvent(gap, noteOn, lowPitch, velocity);
+            builder.writeChannelEvent(0, noteOn, highPitch, velocity);
+            builder.writeChannelEvent(s_division / 4, noteOn, lowPitch, 0);
+            builder.writeChannelEvent(0, noteOn, highPitch, 0);
+        }
+        builder.endTrack();
+    }
+} // namespace
+
+smfBenchmarkUtils::SyntheticSmf smfBenchmarkUtils::makeSyntheticSmf(int numTracks, int numNotesPerTrack) {
+    SyntheticSmf smf;
+    SmfBuilder builder(smf);
+
+    writeHeader(builder, numTracks + 1);
+
+    // A note pair lasts about 0.7 beats on average, so a bar holds about six.
+    writeConductorTrack(builder, (numNotesPerTrack / 2) / 6 + 1);
+    for (int i = 1; i <= numTracks; ++i) {
+        writeNoteTrack(builder, i, numNotesPerTrack);
+    }
+    return smf;
+}
+
+smfBenchmarkUtils::SyntheticSmf smfBenchmarkUtils::makeSyntheticPercussionSmf(PercussionSpec spec, int numTracks,
+                                                                              int numNotesPerTrack) {
+    SyntheticSmf smf;
+    SmfBuilder builder(smf);
+
+    writeHeader(builder, numTracks + 1);
+
+    beginConductorTrack(builder);
+    switch (spec) {
+        case PercussionSpec::GM:
+            builder.writeSysExEvent(0, s_gmSystemOn);
+            break;
+        case PercussionSpec::GS:
+            builder.writeSysExEvent(0, s_gsReset);
+            // Use drum map 1 for the part on channel 9, and select the 808/909 kit.
+            builder.writeSysExEvent(0, "\x41\x10\x42\x12\x40\x10\x15\x01\x1A\xF7"sv);
+            builder.writeChannelEvent(0, 0xC9, 26);
+            break;
+        case PercussionSpec::XG:
+            builder.writeSysExEvent(0, s_xgSystemOn);
+            // The electro kit.
+            builder.writeChannelEvent(0, 0xB9, 0x00, 0x7F);
+            builder.writeChannelEvent(0, 0xC9, 25);
+            break;
+    }
+    // A note pair lasts half a beat on average, so a bar holds about eight.
+    endConductorTrack(builder, (numNotesPerTrack / 2) / 8 + 1);
+
+    for (int i = 1; i <= numTracks; ++i) {
+        writePercussionTrack(builder, i, numNotesPerTrack);
+    }
+    return smf;
+}
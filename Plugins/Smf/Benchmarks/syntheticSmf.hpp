@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Common/types.hpp>
+
+#include <vector>
+
+namespace smfBenchmarkUtils {
+    struct SyntheticSmf {
+        /// The contents of a format 1 Standard MIDI File.
+        std::vector<babelwires::Byte> m_data;
+        /// The number of MIDI, SysEx and meta events in the file.
+        int m_numEvents = 0;
+    };
+
+    /// Generate a format 1 file with a conductor track and numTracks further tracks.
+    /// The conductor track carries tempo, time signature, text and marker meta-events and SysEx messages which
+    /// reset the synthesizer. Each further track uses channel (trackIndex % 16), so channel 9 is percussion when
+    /// there are enough tracks. Notes come in overlapping pairs and are encoded with running status and velocity 0
+    /// note-offs, with occasional controller changes which interrupt the running status.
+    /// The content is deterministic, so results are comparable between runs.
+    SyntheticSmf makeSyntheticSmf(int numTracks, int numNotesPerTrack);
+
+    /// The reset message which determines how the percussion in a file is interpreted.
+    enum class PercussionSpec { GM, GS, XG };
+
+    /// Generate a format 1 file whose numTracks note tracks all play percussion on channel 9.
+    /// The conductor track resets the synthesizer to the given spec and, for GS and XG, selects a kit other than the
+    /// standard one. The notes use the whole pitch range of the kits, including pitches outside them.
+    SyntheticSmf makeSyntheticPercussionSmf(PercussionSpec spec, int numTracks, int numNotesPerTrack);
+} // namespace smfBenchmarkUtils
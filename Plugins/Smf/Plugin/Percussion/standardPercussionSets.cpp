@@ -40,6 +40,7 @@
 #include <BabelWiresLib/Project/projectContext.hpp>
 #include <BabelWiresLib/TypeSystem/typeSystem.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 smf::StandardPercussionSets::StandardPercussionSets(const babelwires::ProjectContext& projectContext) {
@@ -76,10 +77,22 @@ smf::StandardPercussionSets::StandardPercussionSets(const babelwires::ProjectCon
     DECLARE_PERCUSSION_SET(XG_SFX_2_PERCUSSION_SET, smf::XgSFX2PercussionSet)
 
 #undef DECLARE_PERCUSSION_SET
+
+    for (int i = 0; i < NUM_KNOWN_PERCUSSION_SETS; ++i) {
+        for (auto instrument : m_knownSets[i]->getValueSet()) {
+            const auto [it, _] = m_instrumentIndices.try_emplace(instrument, m_instrumentIndices.size());
+            assert((it->second < s_maxNumInstruments) && "Increase s_maxNumInstruments");
+            m_instrumentSets[i].set(it->second);
+        }
+    }
+}
+
+const smf::StandardPercussionSets& smf::StandardPercussionSets::get(const babelwires::ProjectContext& projectContext) {
+    return projectContext.m_typeSystem.getEntryByType<GMSpecType>().getStandardPercussionSets(projectContext);
 }
 
 const bw_music::PercussionSetWithPitchMap*
-smf::StandardPercussionSets::getDefaultPercussionSet(GMSpecType::Value gmSpec, int channelNumber) {
+smf::StandardPercussionSets::getDefaultPercussionSet(GMSpecType::Value gmSpec, int channelNumber) const {
     switch (gmSpec) {
         case GMSpecType::Value::GM:
             if (channelNumber == 9) {
@@ -106,7 +119,7 @@ smf::StandardPercussionSets::getDefaultPercussionSet(GMSpecType::Value gmSpec, i
 
 const bw_music::PercussionSetWithPitchMap*
 smf::StandardPercussionSets::getPercussionSetFromChannelSetupInfo(GMSpecType::Value gmSpec,
-                                                                  ChannelSetupInfo channelSetupInfo) {
+                                                                  ChannelSetupInfo channelSetupInfo) const {
     if (gmSpec == GMSpecType::Value::GM2) {
         if (channelSetupInfo.m_bankMSB == 0x78) {
             switch (channelSetupInfo.m_program) {
@@ -211,87 +224,173 @@ smf::StandardPercussionSets::getPercussionSetFromChannelSetupInfo(GMSpecType::Va
     return nullptr;
 }
 
-void smf::StandardPercussionSets::ensureInstrumentSets() {
-    if (m_instrumentSets[0].size() > 0) {
-        return;
-    }
-    for (int i = 0; i < NUM_KNOWN_PERCUSSION_SETS; ++i) {
-        const babelwires::EnumType::ValueSet& instruments = m_knownSets[i]->getValueSet();
-        std::for_each(instruments.begin(), instruments.end(),
-                      [this, i](auto instrument) { m_instrumentSets[i].insert(instrument); });
+smf::StandardPercussionSets::InstrumentsInUse
+smf::StandardPercussionSets::getInstrumentsInUse(const std::unordered_set<babelwires::ShortId>& instruments) const {
+    InstrumentsInUse instrumentsInUse;
+    for (auto instrument : instruments) {
+        const auto it = m_instrumentIndices.find(instrument);
+        if (it != m_instrumentIndices.end()) {
+            instrumentsInUse.m_knownInstruments.set(it->second);
+        } else {
+            ++instrumentsInUse.m_numUnknownInstruments;
+        }
     }
+    return instrumentsInUse;
 }
 
-void smf::StandardPercussionSets::getExcludedInstruments(
-    int percussionSetIndex, const std::unordered_set<babelwires::ShortId>& instrumentsInUse,
-    std::unordered_set<babelwires::ShortId>& excludedInstrumentsOut) {
-    ensureInstrumentSets();
-    for (auto instrument : instrumentsInUse) {
-        if (m_instrumentSets[percussionSetIndex].find(instrument) == m_instrumentSets[percussionSetIndex].end()) {
-            excludedInstrumentsOut.insert(instrument);
+unsigned int smf::StandardPercussionSets::getNumExcludedInstruments(int percussionSetIndex,
+                                                                    const InstrumentsInUse& instrumentsInUse) const {
+    return (instrumentsInUse.m_knownInstruments & ~m_instrumentSets[percussionSetIndex]).count() +
+           instrumentsInUse.m_numUnknownInstruments;
+}
+
+smf::StandardPercussionSets::KnownPercussionSets
+smf::StandardPercussionSets::getBestPercussionSetInRange(int startIndex, int endIndex,
+                                                         const InstrumentsInUse& instrumentsInUse) const {
+    KnownPercussionSets bestFit = NOT_PERCUSSION;
+    unsigned int fewestExclusions = instrumentsInUse.getNumInstruments();
+
+    for (int i = startIndex; i <= endIndex; ++i) {
+        const unsigned int numExclusions = getNumExcludedInstruments(i, instrumentsInUse);
+        if (numExclusions < fewestExclusions) {
+            bestFit = static_cast<KnownPercussionSets>(i);
+            fewestExclusions = numExclusions;
         }
     }
+    return bestFit;
 }
 
-const bw_music::PercussionSetWithPitchMap* smf::StandardPercussionSets::getBestPercussionSetInRange(
-    int startIndex, int endIndex, const std::unordered_set<babelwires::ShortId>& instrumentsInUse,
-    std::unordered_set<babelwires::ShortId>& excludedInstrumentsOut) {
+void smf::StandardPercussionSets::assignPercussionSet(KnownPercussionSets percussionSet, babelwires::Byte gsPartMode,
+                                                      const InstrumentsInUse& instrumentsInUse,
+                                                      PercussionSetAssignment& assignmentOut) const {
+    if (percussionSet == NOT_PERCUSSION) {
+        return;
+    }
+    const unsigned int numExclusions = getNumExcludedInstruments(percussionSet, instrumentsInUse);
+    if (numExclusions < assignmentOut.m_numExcludedInstruments) {
+        assignmentOut.m_percussionSet = m_knownSets[percussionSet];
+        assignmentOut.m_channelSetupInfo = getChannelSetupInfoFromKnownPercussionSet(percussionSet, gsPartMode);
+        assignmentOut.m_numExcludedInstruments = numExclusions;
+    }
+}
 
-    int bestFit = NOT_PERCUSSION;
-    std::unordered_set<babelwires::ShortId> candidateExclusions;
-    excludedInstrumentsOut = instrumentsInUse;
+std::array<smf::StandardPercussionSets::PercussionSetAssignment, 16> smf::StandardPercussionSets::assignPercussionSets(
+    GMSpecType::Value gmSpec, const std::array<std::unordered_set<babelwires::ShortId>, 16>& instrumentsInUse) const {
+    std::array<InstrumentsInUse, 16> instrumentSets;
+    std::array<PercussionSetAssignment, 16> assignments;
+    for (int i = 0; i < 16; ++i) {
+        instrumentSets[i] = getInstrumentsInUse(instrumentsInUse[i]);
+        // Until a set is assigned, nothing can be represented.
+        assignments[i].m_numExcludedInstruments = instrumentSets[i].getNumInstruments();
+    }
 
-    for (int i = startIndex; i <= endIndex; ++i) {
-        candidateExclusions.clear();
-        getExcludedInstruments(i, instrumentsInUse, candidateExclusions);
-        if ((candidateExclusions.size() < excludedInstrumentsOut.size())) {
-            bestFit = i;
-            excludedInstrumentsOut.swap(candidateExclusions);
-        }
+    switch (gmSpec) {
+        case GMSpecType::Value::GM:
+            assignPercussionSet(GM_PERCUSSION_SET, 0, instrumentSets[9], assignments[9]);
+            break;
+        case GMSpecType::Value::GM2:
+            assignGm2PercussionSets(instrumentSets, assignments);
+            break;
+        case GMSpecType::Value::GS:
+            assignGsPercussionSets(instrumentSets, assignments);
+            break;
+        case GMSpecType::Value::XG:
+            // There are no constraints which channels support XG percussion
+            for (int i = 0; i < 16; ++i) {
+                assignPercussionSet(getBestPercussionSetInRange(XG_SETS_START, XG_SETS_END, instrumentSets[i]), 0,
+                                    instrumentSets[i], assignments[i]);
+            }
+            break;
+        case GMSpecType::Value::NONE:
+        default:
+            break;
     }
-    return (bestFit == NOT_PERCUSSION) ? nullptr : m_knownSets[bestFit];
+    return assignments;
 }
 
-const bw_music::PercussionSetWithPitchMap*
-smf::StandardPercussionSets::getBestPercussionSet(GMSpecType::Value gmSpec, int channelNumber,
-                                                  const std::unordered_set<babelwires::ShortId>& instrumentsInUse,
-                                                  std::unordered_set<babelwires::ShortId>& excludedInstrumentsOut) {
-    if (gmSpec == GMSpecType::Value::GM) {
-        if (channelNumber == 9) {
-            return getBestPercussionSetInRange(GM_PERCUSSION_SET, GM_PERCUSSION_SET, instrumentsInUse,
-                                               excludedInstrumentsOut);
+void smf::StandardPercussionSets::assignGm2PercussionSets(const std::array<InstrumentsInUse, 16>& instrumentsInUse,
+                                                          std::array<PercussionSetAssignment, 16>& assignmentsOut) const {
+    // Each channel can use its own best set, so this just has to pick the two channels which gain most.
+    // Ties go to the conventional rhythm channels.
+    std::array<int, 16> channels = {9, 10, 0, 1, 2, 3, 4, 5, 6, 7, 8, 11, 12, 13, 14, 15};
+    std::array<KnownPercussionSets, 16> bestFits;
+    std::array<unsigned int, 16> numRepresented;
+    for (int i = 0; i < 16; ++i) {
+        bestFits[i] = getBestPercussionSetInRange(GM2_SETS_START, GM2_SETS_END, instrumentsInUse[i]);
+        numRepresented[i] =
+            (bestFits[i] == NOT_PERCUSSION)
+                ? 0
+                : instrumentsInUse[i].getNumInstruments() - getNumExcludedInstruments(bestFits[i], instrumentsInUse[i]);
+    }
+    std::stable_sort(channels.begin(), channels.end(),
+                     [&numRepresented](int a, int b) { return numRepresented[a] > numRepresented[b]; });
+    for (int i = 0; i < 2; ++i) {
+        const int channelNumber = channels[i];
+        assignPercussionSet(bestFits[channelNumber], 0, instrumentsInUse[channelNumber], assignmentsOut[channelNumber]);
+    }
+}
+
+void smf::StandardPercussionSets::assignGsPercussionSets(const std::array<InstrumentsInUse, 16>& instrumentsInUse,
+                                                         std::array<PercussionSetAssignment, 16>& assignmentsOut) const {
+    // Given the sets in the two drum maps, each channel can independently use whichever represents more of its
+    // instruments, so trying every pair of sets finds the best assignment. Single sets are tried first, so a
+    // second drum map is only used when it helps.
+    constexpr int numGsSets = GS_SETS_END - GS_SETS_START + 1;
+    std::array<std::array<unsigned int, numGsSets>, 16> numRepresented;
+    for (int i = 0; i < 16; ++i) {
+        for (int s = 0; s < numGsSets; ++s) {
+            numRepresented[i][s] = instrumentsInUse[i].getNumInstruments() -
+                                   getNumExcludedInstruments(GS_SETS_START + s, instrumentsInUse[i]);
         }
-    } else if (gmSpec == GMSpecType::Value::GM2) {
-        if ((channelNumber == 9) || (channelNumber == 10)) {
-            return getBestPercussionSetInRange(GM2_SETS_START, GM2_SETS_END, instrumentsInUse, excludedInstrumentsOut);
+    }
+
+    const auto getTotalRepresented = [&numRepresented](int setA, int setB) {
+        unsigned int total = 0;
+        for (int i = 0; i < 16; ++i) {
+            total += std::max(numRepresented[i][setA], numRepresented[i][setB]);
         }
-    } else if (gmSpec == GMSpecType::Value::GS) {
-        // This is a simplification for BabelWires-Music rather than a constraint of GS.
-        // Limiting percussion to two channels means I can allocate one percussion part to each without
-        // having to write an algorithm to pick the best assignment of two percussion sets across all channels.
-        // TODO Write that algorithm.
-        if ((channelNumber == 9) || (channelNumber == 10)) {
-            return getBestPercussionSetInRange(GS_SETS_START, GS_SETS_END, instrumentsInUse, excludedInstrumentsOut);
+        return total;
+    };
+
+    int bestA = 0;
+    int bestB = 0;
+    unsigned int bestTotal = 0;
+    for (int a = 0; a < numGsSets; ++a) {
+        const unsigned int total = getTotalRepresented(a, a);
+        if (total > bestTotal) {
+            bestA = bestB = a;
+            bestTotal = total;
+        }
+    }
+    for (int a = 0; a < numGsSets; ++a) {
+        for (int b = a + 1; b < numGsSets; ++b) {
+            const unsigned int total = getTotalRepresented(a, b);
+            if (total > bestTotal) {
+                bestA = a;
+                bestB = b;
+                bestTotal = total;
+            }
         }
-    } else if (gmSpec == GMSpecType::Value::XG) {
-        // There are no constraints which channels support XG percussion
-        return getBestPercussionSetInRange(XG_SETS_START, XG_SETS_END, instrumentsInUse, excludedInstrumentsOut);
     }
-    excludedInstrumentsOut = instrumentsInUse;
-    return nullptr;
-}
 
-smf::StandardPercussionSets::KnownPercussionSets smf::StandardPercussionSets::getKnownPercussionSetFromPercussionSet(
-    const bw_music::PercussionSetWithPitchMap* percussionSet) {
-    const auto it = std::find(m_knownSets.begin(), m_knownSets.end(), percussionSet);
-    assert((it != m_knownSets.end()) && "Percussion set not known");
-    return static_cast<KnownPercussionSets>(it - m_knownSets.begin());
+    if (bestTotal == 0) {
+        return;
+    }
+    for (int i = 0; i < 16; ++i) {
+        // Drum map 1 is preferred when the sets are equally good.
+        if (numRepresented[i][bestB] > numRepresented[i][bestA]) {
+            assignPercussionSet(static_cast<KnownPercussionSets>(GS_SETS_START + bestB), 2, instrumentsInUse[i],
+                                assignmentsOut[i]);
+        } else {
+            assignPercussionSet(static_cast<KnownPercussionSets>(GS_SETS_START + bestA), 1, instrumentsInUse[i],
+                                assignmentsOut[i]);
+        }
+    }
 }
 
 std::optional<smf::StandardPercussionSets::ChannelSetupInfo>
 smf::StandardPercussionSets::getChannelSetupInfoFromKnownPercussionSet(KnownPercussionSets percussionSet,
-                                                                       int channelNumber) {
-    const babelwires::Byte gsPartNumber = channelNumber - 8;
+                                                                       babelwires::Byte gsPartMode) const {
     switch (percussionSet) {
         default:
         case NOT_PERCUSSION:
@@ -316,23 +415,23 @@ smf::StandardPercussionSets::getChannelSetupInfoFromKnownPercussionSet(KnownPerc
         case GM2_SFX_PERCUSSION_SET:
             return {{0x78, 0, 57, 0}};
         case GS_STANDARD_1_PERCUSSION_SET:
-            return {{0x02, 0, 1, gsPartNumber}};
+            return {{0x02, 0, 1, gsPartMode}};
         case GS_ROOM_PERCUSSION_SET:
-            return {{0x02, 0, 9, gsPartNumber}};
+            return {{0x02, 0, 9, gsPartMode}};
         case GS_POWER_PERCUSSION_SET:
-            return {{0x02, 0, 17, gsPartNumber}};
+            return {{0x02, 0, 17, gsPartMode}};
         case GS_ELECTRONIC_PERCUSSION_SET:
-            return {{0x02, 0, 25, gsPartNumber}};
+            return {{0x02, 0, 25, gsPartMode}};
         case GS_808_909_PERCUSSION_SET:
-            return {{0x02, 0, 26, gsPartNumber}};
+            return {{0x02, 0, 26, gsPartMode}};
         case GS_JAZZ_PERCUSSION_SET:
-            return {{0x02, 0, 33, gsPartNumber}};
+            return {{0x02, 0, 33, gsPartMode}};
         case GS_BRUSH_PERCUSSION_SET:
-            return {{0x02, 0, 41, gsPartNumber}};
+            return {{0x02, 0, 41, gsPartMode}};
         case GS_ORCHESTRA_PERCUSSION_SET:
-            return {{0x02, 0, 49, gsPartNumber}};
+            return {{0x02, 0, 49, gsPartMode}};
         case GS_SFX_PERCUSSION_SET:
-            return {{0x02, 0, 57, gsPartNumber}};
+            return {{0x02, 0, 57, gsPartMode}};
         case XG_STANDARD_1_PERCUSSION_SET:
             return {{0x7f, 0, 1, 0}};
         case XG_ROOM_PERCUSSION_SET:
@@ -355,14 +454,3 @@ smf::StandardPercussionSets::getChannelSetupInfoFromKnownPercussionSet(KnownPerc
             return {{0x7e, 0, 2, 0}};
     }
 }
-
-std::optional<smf::StandardPercussionSets::ChannelSetupInfo>
-smf::StandardPercussionSets::getChannelSetupInfoFromPercussionSet(
-    const bw_music::PercussionSetWithPitchMap* percussionSet, int channelNumber) {
-    if (percussionSet) {
-        const KnownPercussionSets knownPercussionSet = getKnownPercussionSetFromPercussionSet(percussionSet);
-        return getChannelSetupInfoFromKnownPercussionSet(knownPercussionSet, channelNumber);
-    } else {
-        return {};
-    }
-}
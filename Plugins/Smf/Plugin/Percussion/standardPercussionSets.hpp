@@ -12,6 +12,10 @@
 
 #include <MusicLib/Percussion/builtInPercussionInstruments.hpp>
 
+#include <array>
+#include <bitset>
+#include <optional>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace babelwires {
@@ -19,34 +23,45 @@ namespace babelwires {
 }
 
 namespace smf {
+    /// The percussion sets of the MIDI specifications, and the knowledge of how to select them.
+    /// An instance is immutable once constructed, so parsers and writers can share it across threads.
     class StandardPercussionSets {
       public:
         StandardPercussionSets(const babelwires::ProjectContext& projectContext);
 
+        /// Get the instance shared by everything which uses the given context. It is built on first use.
+        static const StandardPercussionSets& get(const babelwires::ProjectContext& projectContext);
+
         /// Get the default set for each channel in the given spec.
-        const bw_music::PercussionSetWithPitchMap* getDefaultPercussionSet(GMSpecType::Value gmSpec, int channelNumber);
+        const bw_music::PercussionSetWithPitchMap* getDefaultPercussionSet(GMSpecType::Value gmSpec, int channelNumber) const;
 
         // TODO This isn't percussion specific.
         struct ChannelSetupInfo {
             babelwires::Byte m_bankMSB = 0;
             babelwires::Byte m_bankLSB = 0;
             babelwires::Byte m_program = 0;
-            /// This is the part corresponding to this channel, irrespective of the part mapping.
+            /// The GS "use for rhythm part" value: 0 for a normal part, or the drum map (1 or 2) of a rhythm part.
             babelwires::Byte m_gsPartMode = 0;
         };
 
         /// Get the percussion set specified by the given parameters, or nullptr if a percussion set is not specified.
-        const bw_music::PercussionSetWithPitchMap* getPercussionSetFromChannelSetupInfo(GMSpecType::Value gmSpec, ChannelSetupInfo channelSetupInfo);
-
-        /// Find the percussion set which contains the most instruments from the given set, and is suitable for use in
-        /// the given channel.
-        const bw_music::PercussionSetWithPitchMap* getBestPercussionSet(GMSpecType::Value gmSpec, int channelNumber,
-                                                  const std::unordered_set<babelwires::ShortId>& instrumentsInUse,
-                                                  std::unordered_set<babelwires::ShortId>& excludedInstrumentsOut);
+        const bw_music::PercussionSetWithPitchMap* getPercussionSetFromChannelSetupInfo(GMSpecType::Value gmSpec, ChannelSetupInfo channelSetupInfo) const;
+
+        /// The choice of percussion set for one channel.
+        struct PercussionSetAssignment {
+            /// This is null if the channel should not be used for percussion.
+            const bw_music::PercussionSetWithPitchMap* m_percussionSet = nullptr;
+            /// The set-up which selects the percussion set, if any is required.
+            std::optional<ChannelSetupInfo> m_channelSetupInfo;
+            /// The number of instruments in use in the channel which the assignment cannot represent.
+            unsigned int m_numExcludedInstruments = 0;
+        };
 
-        /// Get setup information for the given percussionSet if any is required. 
-        /// A null argument is allowed, in which case an empty optional is returned.
-        std::optional<ChannelSetupInfo> getChannelSetupInfoFromPercussionSet(const bw_music::PercussionSetWithPitchMap* percussionSet, int channelNumber);
+        /// Choose percussion sets for all channels together, so that as many of the instruments in use as possible
+        /// are represented within the spec's limits on percussion parts.
+        std::array<PercussionSetAssignment, 16>
+        assignPercussionSets(GMSpecType::Value gmSpec,
+                             const std::array<std::unordered_set<babelwires::ShortId>, 16>& instrumentsInUse) const;
 
       private:
         enum KnownPercussionSets {
@@ -98,28 +113,57 @@ namespace smf {
             XG_SETS_END = XG_SFX_2_PERCUSSION_SET,
         };
 
-        /// Ensure the m_instrumentSets array is populated.
-        void ensureInstrumentSets();
+        /// Enough bits for the built-in instruments and a few others which the known sets use.
+        static constexpr unsigned int s_maxNumInstruments =
+            static_cast<unsigned int>(bw_music::BuiltInPercussionInstruments::Value::NUM_VALUES) + 16;
 
-        /// Get the set of instruments in instrumentsInUse missing from the percussion set at the given index.
-        void getExcludedInstruments(int percussionSetIndex, const std::unordered_set<babelwires::ShortId>& instrumentsInUse,
-                                                  std::unordered_set<babelwires::ShortId>& excludedInstrumentsOut);
+        /// A set of instruments, represented by their indices in m_instrumentIndices.
+        using InstrumentSet = std::bitset<s_maxNumInstruments>;
+
+        /// The instruments in use in one channel.
+        struct InstrumentsInUse {
+            /// The instruments which belong to at least one known set.
+            InstrumentSet m_knownInstruments;
+            /// Instruments which belong to no known set can never be represented, so they are just counted.
+            unsigned int m_numUnknownInstruments = 0;
+
+            unsigned int getNumInstruments() const { return m_knownInstruments.count() + m_numUnknownInstruments; }
+        };
 
-        /// From the range of known percussion, select the best percussion set.
-        const bw_music::PercussionSetWithPitchMap* getBestPercussionSetInRange(int startIndex, int endIndex,
-                                                  const std::unordered_set<babelwires::ShortId>& instrumentsInUse,
-                                                  std::unordered_set<babelwires::ShortId>& excludedInstrumentsOut);
+        InstrumentsInUse getInstrumentsInUse(const std::unordered_set<babelwires::ShortId>& instruments) const;
 
-        /// Find the percussion set in the array of known percussion sets. Asserts if not found.
-        KnownPercussionSets getKnownPercussionSetFromPercussionSet(const bw_music::PercussionSetWithPitchMap* percussionSet);
+        /// The number of instruments in use which the known set at the given index cannot represent.
+        unsigned int getNumExcludedInstruments(int percussionSetIndex, const InstrumentsInUse& instrumentsInUse) const;
 
-        std::optional<ChannelSetupInfo> getChannelSetupInfoFromKnownPercussionSet(KnownPercussionSets percussionSet, int channelNumber);
+        /// From the range of known percussion sets, select the one which excludes the fewest instruments.
+        /// Returns NOT_PERCUSSION if none of them represents any of the instruments.
+        KnownPercussionSets getBestPercussionSetInRange(int startIndex, int endIndex,
+                                                        const InstrumentsInUse& instrumentsInUse) const;
+
+        /// Assign the known set to the channel, if it represents any of the instruments in use.
+        void assignPercussionSet(KnownPercussionSets percussionSet, babelwires::Byte gsPartMode,
+                                 const InstrumentsInUse& instrumentsInUse,
+                                 PercussionSetAssignment& assignmentOut) const;
+
+        /// GS allows any channel to be a rhythm part, but there are only two drum maps to share between them.
+        void assignGsPercussionSets(const std::array<InstrumentsInUse, 16>& instrumentsInUse,
+                                    std::array<PercussionSetAssignment, 16>& assignmentsOut) const;
+
+        /// GM2 allows any channel to be a rhythm channel, but at most two at a time.
+        void assignGm2PercussionSets(const std::array<InstrumentsInUse, 16>& instrumentsInUse,
+                                     std::array<PercussionSetAssignment, 16>& assignmentsOut) const;
+
+        std::optional<ChannelSetupInfo> getChannelSetupInfoFromKnownPercussionSet(KnownPercussionSets percussionSet,
+                                                                                  babelwires::Byte gsPartMode) const;
 
       private:
         std::array<const bw_music::PercussionSetWithPitchMap*, NUM_KNOWN_PERCUSSION_SETS> m_knownSets;
 
-        /// This is populated on demand.
-        std::array<std::unordered_set<babelwires::ShortId>, NUM_KNOWN_PERCUSSION_SETS> m_instrumentSets;
+        /// Every instrument in any known set, mapped to its bit in an InstrumentSet.
+        std::unordered_map<babelwires::ShortId, unsigned int> m_instrumentIndices;
+
+        /// The instruments of each known set.
+        std::array<InstrumentSet, NUM_KNOWN_PERCUSSION_SETS> m_instrumentSets;
     };
 
 } // namespace smf
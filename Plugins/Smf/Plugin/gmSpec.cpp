@@ -7,9 +7,18 @@
  **/
 #include <Plugins/Smf/Plugin/gmSpec.hpp>
 
+#include <Plugins/Smf/Plugin/Percussion/standardPercussionSets.hpp>
+
 #include <Common/Identifiers/identifierRegistry.hpp>
 
 ENUM_DEFINE_ENUM_VALUE_SOURCE(smf::GMSpecType, GM_SPEC_VALUES);
 
 smf::GMSpecType::GMSpecType()
     : EnumType(getStaticValueSet(), 1) {}
+
+smf::GMSpecType::~GMSpecType() = default;
+
+const smf::StandardPercussionSets&
+smf::GMSpecType::getStandardPercussionSets(const babelwires::ProjectContext& projectContext) const {
+    return m_standardPercussionSets.get([&projectContext]() { return StandardPercussionSets(projectContext); });
+}
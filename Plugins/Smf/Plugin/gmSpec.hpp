@@ -12,6 +12,8 @@
 #include <BabelWiresLib/Instance/enumTypeInstance.hpp>
 #include <BabelWiresLib/Instance/instance.hpp>
 
+#include <MusicLib/Utilities/lazilyComputedValue.hpp>
+
 #define GM_SPEC_VALUES(X)                                                                                              \
     X(NONE, "No Specification", "0d8e86c7-3d0c-4a6c-8fb0-3aaa0410dfc1")                                                \
     X(GM, "General MIDI", "241ae73e-f1a2-490a-8341-1456b3dcc1fa")                                                      \
@@ -19,13 +21,28 @@
     X(XG, "Yamaha XG", "6be100b8-c581-4613-8cd3-c3f44c40f98d")                                                         \
     X(GM2, "General MIDI 2", "11fb43e0-f04c-44fc-bb84-6ebec830321d")
 
+namespace babelwires {
+    struct ProjectContext;
+}
+
 namespace smf {
+    class StandardPercussionSets;
+
     /// Carries the enum of GM Spec values.
     class GMSpecType : public babelwires::EnumType {
       public:
         PRIMITIVE_TYPE("GMSpec", "GM Specification", "4dc2566d-1be8-468b-9aa0-2f4d63344a13", 1);
         GMSpecType();
+        ~GMSpecType();
 
         ENUM_DEFINE_CPP_ENUM(GM_SPEC_VALUES);
+
+        /// The percussion sets of the specs are built on first use and then shared. Since this type is registered
+        /// with the percussion sets, the shared instance has the same lifetime as them.
+        /// Prefer StandardPercussionSets::get.
+        const StandardPercussionSets& getStandardPercussionSets(const babelwires::ProjectContext& projectContext) const;
+
+      private:
+        bw_music::LazilyComputedValue<StandardPercussionSets> m_standardPercussionSets;
     };
 } // namespace smf
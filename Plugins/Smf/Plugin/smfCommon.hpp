@@ -8,8 +8,11 @@
 #pragma once
 
 #include <MusicLib/Types/Track/trackType.hpp>
-
+#include <MusicLib/musicTypes.hpp>
 
 namespace smf {
     using TypeOfTracks = bw_music::DefaultTrackType;
+
+    /// A note-on with velocity 0 stands for a note-off with this velocity.
+    constexpr bw_music::Velocity c_defaultNoteOffVelocity = 64;
 }
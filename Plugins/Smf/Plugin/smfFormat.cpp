@@ -13,7 +13,6 @@
 #include <Plugins/Smf/Plugin/smfParser.hpp>
 #include <Plugins/Smf/Plugin/smfWriter.hpp>
 
-#include <Common/IO/fileDataSource.hpp>
 #include <Common/IO/outFileStream.hpp>
 
 namespace {
@@ -33,6 +32,10 @@ babelwires::LongId smf::SmfSourceFormat::getThisIdentifier() {
     return s_formatIdentifier;
 }
 
+void smf::SmfSourceFormat::setMaxParserThreads(unsigned int maxParserThreads) {
+    m_maxParserThreads = maxParserThreads;
+}
+
 std::string smf::SmfSourceFormat::getManufacturerName() const {
     return s_manufacturerName;
 }
@@ -44,8 +47,7 @@ std::string smf::SmfSourceFormat::getProductName() const {
 std::unique_ptr<babelwires::ValueTreeRoot>
 smf::SmfSourceFormat::loadFromFile(const std::filesystem::path& path, const babelwires::ProjectContext& projectContext,
                                    babelwires::UserLogger& userLogger) const {
-    babelwires::FileDataSource dataSource(path);
-    return parseSmfSequence(dataSource, projectContext, userLogger);
+    return parseSmfFile(path, projectContext, userLogger, m_maxParserThreads);
 }
 
 smf::SmfTargetFormat::SmfTargetFormat()
@@ -17,11 +17,17 @@ namespace smf {
         SmfSourceFormat();
         static babelwires::LongId getThisIdentifier();
 
+        /// Limit the number of threads used to parse each file. See SmfParser::setMaxThreads.
+        void setMaxParserThreads(unsigned int maxParserThreads);
+
         virtual std::string getManufacturerName() const override;
         virtual std::string getProductName() const override;
         virtual std::unique_ptr<babelwires::ValueTreeRoot>
         loadFromFile(const std::filesystem::path& path, const babelwires::ProjectContext& projectContext,
                      babelwires::UserLogger& userLogger) const override;
+
+      private:
+        unsigned int m_maxParserThreads = 0;
     };
 
     /// Format for creating Standard MIDI Files.
@@ -9,10 +9,12 @@
 
 #include <Plugins/Smf/Plugin/Percussion/gm2StandardPercussionSet.hpp>
 #include <Plugins/Smf/Plugin/Percussion/gmPercussionSet.hpp>
+#include <Plugins/Smf/Plugin/smfCommon.hpp>
 
 #include <MusicLib/Percussion/builtInPercussionInstruments.hpp>
 #include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
 #include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
+#include <MusicLib/Utilities/parallelFor.hpp>
 
 #include <BabelWiresLib/Project/projectContext.hpp>
 #include <BabelWiresLib/TypeSystem/typeSystem.hpp>
@@ -23,7 +25,9 @@
 
 #include <cassert>
 #include <cmath>
+#include <fstream>
 #include <iomanip>
+#include <optional>
 
 namespace {
     static const int MAX_CHANNELS = 16;
@@ -32,15 +36,17 @@ namespace {
     const std::array<unsigned int, 16> s_gsBlockToPartMapping{10, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 12, 13, 14, 15, 16};
 } // namespace
 
-smf::SmfParser::SmfParser(babelwires::DataSource& dataSource, const babelwires::ProjectContext& projectContext,
+smf::SmfParser::SmfParser(std::span<const babelwires::Byte> data, const babelwires::ProjectContext& projectContext,
                           babelwires::UserLogger& userLogger)
     : m_projectContext(projectContext)
-    , m_dataSource(dataSource)
     , m_userLogger(userLogger)
+    , m_data(data)
+    , m_next(data.data())
+    , m_end(data.data() + data.size())
     , m_sequenceType(Format::SMF_UNKNOWN_FORMAT)
     , m_numTracks(-1)
     , m_division(-1)
-    , m_standardPercussionSets(projectContext) {
+    , m_standardPercussionSets(StandardPercussionSets::get(projectContext)) {
 
     m_result = std::make_unique<babelwires::ValueTreeRoot>(projectContext.m_typeSystem, babelwires::FileTypeT<SmfSequence>::getThisType());
     m_result->setToDefault();
@@ -59,20 +65,21 @@ smf::SmfSequence::Instance smf::SmfParser::getSmfSequence() {
 smf::SmfSequence::Instance getSmfSequence();
 
 
-babelwires::Byte smf::SmfParser::getNext() {
-    try {
-        return m_dataSource.getNextByte();
-    } catch (std::exception&) {
-        throw babelwires::ParseException() << "Stream is truncated";
-    }
+void smf::SmfParser::throwTruncated() const {
+    throw babelwires::ParseException() << "Stream is truncated";
 }
 
-babelwires::Byte smf::SmfParser::peekNext() {
-    try {
-        return m_dataSource.peekNextByte();
-    } catch (std::exception&) {
-        throw babelwires::ParseException() << "Stream is truncated";
-    }
+std::size_t smf::SmfParser::getAbsolutePosition() const {
+    return m_next - m_data.data();
+}
+
+void smf::SmfParser::setMaxThreads(unsigned int maxThreads) {
+    m_maxThreads = maxThreads;
+}
+
+bw_music::Timebase smf::SmfParser::getTimebase() const {
+    // The division is the number of ticks per quarter note.
+    return bw_music::Timebase(m_division * 4);
 }
 
 void smf::SmfParser::readByteSequence(const char* seq) {
@@ -81,7 +88,7 @@ void smf::SmfParser::readByteSequence(const char* seq) {
         const babelwires::Byte c = getNext();
         if (c != *seq) {
             throw babelwires::ParseException()
-                << "Expected " << *seq << " at index " << m_dataSource.getAbsolutePosition() << " but found " << c
+                << "Expected " << *seq << " at index " << getAbsolutePosition() << " but found " << c
                 << " instead";
         }
         ++seq;
@@ -89,59 +96,54 @@ void smf::SmfParser::readByteSequence(const char* seq) {
 }
 
 void smf::SmfParser::skipBytes(int numBytes) {
-    for (int i = 0; i < numBytes; ++i) {
-        getNext();
-    }
+    ensureAvailable(numBytes);
+    m_next += numBytes;
 }
 
 std::uint16_t smf::SmfParser::readU16() {
-    const std::uint32_t b0 = getNext();
-    const std::uint32_t b1 = getNext();
+    ensureAvailable(2);
+    const std::uint32_t b0 = m_next[0];
+    const std::uint32_t b1 = m_next[1];
+    m_next += 2;
     return (b0 << 8) | b1;
 }
 
 std::uint32_t smf::SmfParser::readU24() {
-    const std::uint32_t b0 = getNext();
-    const std::uint32_t b1 = getNext();
-    const std::uint32_t b2 = getNext();
+    ensureAvailable(3);
+    const std::uint32_t b0 = m_next[0];
+    const std::uint32_t b1 = m_next[1];
+    const std::uint32_t b2 = m_next[2];
+    m_next += 3;
     return (b0 << 16) | (b1 << 8) | b2;
 }
 
 std::uint32_t smf::SmfParser::readU32() {
-    const std::uint32_t b0 = getNext();
-    const std::uint32_t b1 = getNext();
-    const std::uint32_t b2 = getNext();
-    const std::uint32_t b3 = getNext();
+    ensureAvailable(4);
+    const std::uint32_t b0 = m_next[0];
+    const std::uint32_t b1 = m_next[1];
+    const std::uint32_t b2 = m_next[2];
+    const std::uint32_t b3 = m_next[3];
+    m_next += 4;
     return (b0 << 24) | (b1 << 16) | (b2 << 8) | b3;
 }
 
 std::uint32_t smf::SmfParser::readVariableLengthQuantity() {
     std::uint32_t result = 0;
-    babelwires::Byte b;
-    int numBytes = 0;
-    do {
-        if (numBytes == 4) {
-            throw babelwires::ParseException() << "Variable Length Quantity too big";
+    for (int numBytes = 0; numBytes < 4; ++numBytes) {
+        const babelwires::Byte b = getNext();
+        result = (result << 7) | (b & 0x7f);
+        if ((b & 0x80) == 0) {
+            return result;
         }
-        ++numBytes;
-
-        b = getNext();
-        result = (result << 7) + (b & 0x7f);
-    } while (b & 0x80);
-    return result;
-}
-
-bw_music::ModelDuration smf::SmfParser::readModelDuration() {
-    const int numDivisions = readVariableLengthQuantity();
-    return bw_music::ModelDuration(numDivisions) * bw_music::ModelDuration(1, m_division * 4);
+    }
+    throw babelwires::ParseException() << "Variable Length Quantity too big";
 }
 
 std::string smf::SmfParser::readTextMetaEvent(int length) {
-    std::vector<char> text;
-    for (int i = 0; i < length; ++i) {
-        text.push_back(getNext());
-    }
-    return std::string(text.data(), length);
+    ensureAvailable(length);
+    std::string text(reinterpret_cast<const char*>(m_next), length);
+    m_next += length;
+    return text;
 }
 
 void smf::SmfParser::readHeaderChunk() {
@@ -166,6 +168,9 @@ void smf::SmfParser::readHeaderChunk() {
     if (m_division & (1 << 15)) {
         throw babelwires::ParseException() << "SMPTE format durations not supported";
     }
+    if (m_division == 0) {
+        throw babelwires::ParseException() << "The division of the Standard MIDI File is zero";
+    }
 }
 
 void smf::SmfParser::parse() {
@@ -198,47 +203,84 @@ void smf::SmfParser::readTempoEvent(std::uint32_t tempoValue) {
     getMidiMetadata().activateAndGetTempo().set(std::round(bpm));
 }
 
+/// Collects the note events of one MIDI track and splits them into a track per channel.
+/// The events are recorded while the MIDI track is read, since their interpretation depends on the channel setup at
+/// that time, but the Tracks are built later by buildTracks, which does not depend on the parser.
 class smf::SmfParser::TrackSplitter {
   public:
     TrackSplitter(const std::array<ChannelSetup, 16>& channelSetup)
         : m_channels{}
         , m_channelSetup(channelSetup) {}
 
-    bool addNoteOn(unsigned int channelNumber, bw_music::ModelDuration timeSinceLastTrackEvent, bw_music::Pitch pitch,
+    bool addNoteOn(unsigned int channelNumber, bw_music::Ticks timeSinceLastTrackEvent, bw_music::Pitch pitch,
                    bw_music::Velocity velocity) {
         if (const bw_music::PercussionSetWithPitchMap* const percussionSet =
                 m_channelSetup[channelNumber].m_kitIfPercussion) {
             if (auto instrument = percussionSet->tryGetInstrumentFromPitch(pitch)) {
-                addToChannel<bw_music::PercussionOnEvent>(channelNumber, timeSinceLastTrackEvent, *instrument,
-                                                          velocity);
+                addRecord(channelNumber, timeSinceLastTrackEvent, EventRecord::Kind::PercussionOn, pitch, velocity,
+                          instrument);
                 return true;
             }
             return false;
         } else {
-            addToChannel<bw_music::NoteOnEvent>(channelNumber, timeSinceLastTrackEvent, pitch, velocity);
+            addRecord(channelNumber, timeSinceLastTrackEvent, EventRecord::Kind::NoteOn, pitch, velocity, {});
             return true;
         }
     }
 
-    bool addNoteOff(unsigned int channelNumber, bw_music::ModelDuration timeSinceLastTrackEvent, bw_music::Pitch pitch,
+    bool addNoteOff(unsigned int channelNumber, bw_music::Ticks timeSinceLastTrackEvent, bw_music::Pitch pitch,
                     bw_music::Velocity velocity) {
         if (const bw_music::PercussionSetWithPitchMap* const percussionSet =
                 m_channelSetup[channelNumber].m_kitIfPercussion) {
             if (auto instrument = percussionSet->tryGetInstrumentFromPitch(pitch)) {
-                addToChannel<bw_music::PercussionOffEvent>(channelNumber, timeSinceLastTrackEvent, *instrument,
-                                                           velocity);
+                addRecord(channelNumber, timeSinceLastTrackEvent, EventRecord::Kind::PercussionOff, pitch, velocity,
+                          instrument);
                 return true;
             }
             return false;
         } else {
-            addToChannel<bw_music::NoteOffEvent>(channelNumber, timeSinceLastTrackEvent, pitch, velocity);
+            addRecord(channelNumber, timeSinceLastTrackEvent, EventRecord::Kind::NoteOff, pitch, velocity, {});
             return true;
         }
     }
 
     /// All channels share the duration of the MIDI track.
-    void setDurationsForAllChannels(bw_music::ModelDuration timeToEndOfTrackEvent) {
-        bw_music::ModelDuration duration = m_timeSinceStart + timeToEndOfTrackEvent;
+    void setDurationsForAllChannels(bw_music::Ticks timeToEndOfTrackEvent) {
+        m_duration = m_timeSinceStart + timeToEndOfTrackEvent;
+    }
+
+    /// Build the tracks of the channels which have events.
+    /// The timebase converts the ticks of the MIDI file into durations.
+    void buildTracks(const bw_music::Timebase& timebase) {
+        std::array<bw_music::Ticks, MAX_CHANNELS> timeOfLastEvent{};
+        for (const EventRecord& record : m_records) {
+            PerChannelInfo* channel = getChannel(record.m_channel);
+            const bw_music::ModelDuration timeSinceLastEvent =
+                timebase.toModelDuration(record.m_time - timeOfLastEvent[record.m_channel]);
+            timeOfLastEvent[record.m_channel] = record.m_time;
+            switch (record.m_kind) {
+                case EventRecord::Kind::NoteOn:
+                    channel->m_track.addEvent(
+                        bw_music::NoteOnEvent{timeSinceLastEvent, record.m_pitch, record.m_velocity});
+                    break;
+                case EventRecord::Kind::NoteOff:
+                    channel->m_track.addEvent(
+                        bw_music::NoteOffEvent{timeSinceLastEvent, record.m_pitch, record.m_velocity});
+                    break;
+                case EventRecord::Kind::PercussionOn:
+                    channel->m_track.addEvent(
+                        bw_music::PercussionOnEvent{timeSinceLastEvent, *record.m_instrument, record.m_velocity});
+                    break;
+                case EventRecord::Kind::PercussionOff:
+                    channel->m_track.addEvent(
+                        bw_music::PercussionOffEvent{timeSinceLastEvent, *record.m_instrument, record.m_velocity});
+                    break;
+            }
+        }
+        m_records.clear();
+        m_records.shrink_to_fit();
+
+        const bw_music::ModelDuration duration = timebase.toModelDuration(m_duration);
         for (int channelNumber = 0; channelNumber < MAX_CHANNELS; ++channelNumber) {
             if (m_channels[channelNumber] != nullptr) {
                 m_channels[channelNumber]->m_track.setDuration(duration);
@@ -248,7 +290,6 @@ class smf::SmfParser::TrackSplitter {
 
   private:
     struct PerChannelInfo {
-        bw_music::ModelDuration m_timeOfLastEvent;
         bw_music::Track m_track;
     };
 
@@ -263,18 +304,35 @@ class smf::SmfParser::TrackSplitter {
         return channel.get();
     }
 
-    template <typename EVENT_TYPE, typename... ARGS>
-    void addToChannel(unsigned int channelNumber, bw_music::ModelDuration timeSinceLastTrackEvent, ARGS&&... args) {
-        PerChannelInfo* channel = getChannel(channelNumber);
+    /// A note or percussion event which has been read but not yet added to a track.
+    struct EventRecord {
+        enum class Kind : std::uint8_t { NoteOn, NoteOff, PercussionOn, PercussionOff };
 
+        /// The time since the start of the MIDI track.
+        bw_music::Ticks m_time;
+        std::uint8_t m_channel;
+        Kind m_kind;
+        bw_music::Pitch m_pitch;
+        bw_music::Velocity m_velocity;
+        /// Only set for percussion events.
+        std::optional<babelwires::ShortId> m_instrument;
+    };
+
+    void addRecord(unsigned int channelNumber, bw_music::Ticks timeSinceLastTrackEvent, EventRecord::Kind kind,
+                   bw_music::Pitch pitch, bw_music::Velocity velocity, std::optional<babelwires::ShortId> instrument) {
+        assert(channelNumber < MAX_CHANNELS);
         m_timeSinceStart += timeSinceLastTrackEvent;
-        channel->m_track.addEvent(
-            EVENT_TYPE{m_timeSinceStart - channel->m_timeOfLastEvent, std::forward<ARGS>(args)...});
-        channel->m_timeOfLastEvent = m_timeSinceStart;
+        m_records.emplace_back(EventRecord{m_timeSinceStart, static_cast<std::uint8_t>(channelNumber), kind, pitch,
+                                           velocity, instrument});
     }
 
   public:
-    bw_music::ModelDuration m_timeSinceStart;
+    bw_music::Ticks m_timeSinceStart = 0;
+
+    /// The time of the end-of-track event.
+    bw_music::Ticks m_duration = 0;
+
+    std::vector<EventRecord> m_records;
 
     std::array<std::unique_ptr<PerChannelInfo>, MAX_CHANNELS> m_channels;
 
@@ -289,10 +347,9 @@ template <typename STREAMLIKE> void smf::SmfParser::logByteSequence(STREAMLIKE l
 }
 
 void smf::SmfParser::readFullMessageIntoBuffer(std::uint32_t length) {
-    m_messageBuffer.resize(length);
-    for (int i = 0; i < length; ++i) {
-        m_messageBuffer[i] = getNext();
-    }
+    ensureAvailable(length);
+    m_messageBuffer.assign(m_next, m_next + length);
+    m_next += length;
 }
 
 template <std::size_t N> bool smf::SmfParser::isMessageBufferMessage(const std::array<std::int16_t, N>& message) const {
@@ -412,11 +469,9 @@ void smf::SmfParser::readSequencerSpecificEvent(int length) {
         logByteSequence(m_userLogger.logWarning() << "Skipping sequencer specific event with invalid length: ", length);
         return;
     }
-    assert(length <= 255 && "Length was expected to be held in one byte");
-    std::array<babelwires::Byte, 255> eventBytes;
-    for (int i = 0; i < length; ++i) {
-        eventBytes[i] = getNext();
-    }
+    ensureAvailable(length);
+    const babelwires::Byte* const eventBytes = m_next;
+    m_next += length;
     auto log = babelwires::logDebug();
     int byteIndex = 0;
     if (eventBytes[0] == 0x43) {
@@ -526,15 +581,28 @@ void smf::SmfParser::readProgramChange(unsigned int channelNumber) {
     setProgram(channelNumber, newProgram);
 }
 
-void smf::SmfParser::readTrack(int trackIndex, TrackSplitter& tracks, bool hasMainMetadata) {
+std::span<const babelwires::Byte> smf::SmfParser::readTrackChunk(int trackIndex) {
     readByteSequence("MTrk");
     const std::uint32_t trackLength = readU32();
-    const int currentIndex = m_dataSource.getAbsolutePosition();
+    if (static_cast<std::size_t>(m_end - m_next) < trackLength) {
+        throw babelwires::ParseException() << "MIDI track " << trackIndex << " is truncated";
+    }
+    const std::span<const babelwires::Byte> trackChunk(m_next, trackLength);
+    m_next += trackLength;
+    return trackChunk;
+}
 
-    bw_music::ModelDuration timeSinceLastNoteEvent = 0;
+void smf::SmfParser::readTrack(int trackIndex, std::span<const babelwires::Byte> trackChunk, TrackSplitter& tracks,
+                               bool hasMainMetadata) {
+    // Reads are confined to the chunk, whose bounds were checked by readTrackChunk.
+    m_next = trackChunk.data();
+    m_end = trackChunk.data() + trackChunk.size();
+
+    // Measured in the ticks of the file's division.
+    bw_music::Ticks timeSinceLastNoteEvent = 0;
     babelwires::Byte lastStatusByte = 0;
-    while ((m_dataSource.getAbsolutePosition() - currentIndex) < trackLength) {
-        timeSinceLastNoteEvent += readModelDuration();
+    while (m_next != m_end) {
+        timeSinceLastNoteEvent += readVariableLengthQuantity();
 
         // Peek in case running status should be used.
         babelwires::Byte statusByte = peekNext();
@@ -644,7 +712,7 @@ void smf::SmfParser::readTrack(int trackIndex, TrackSplitter& tracks, bool hasMa
                         case 0x2F: // End of track.
                         {
                             // Finished.
-                            if ((m_dataSource.getAbsolutePosition() - currentIndex) != trackLength) {
+                            if (m_next != m_end) {
                                 throw babelwires::ParseException()
                                     << "MIDI track " << trackIndex << " had an unexpected end-of-track event";
                             }
@@ -746,7 +814,7 @@ void smf::SmfParser::readTrack(int trackIndex, TrackSplitter& tracks, bool hasMa
                         timeSinceLastNoteEvent = 0;
                     }
                 } else {
-                    if (tracks.addNoteOff(statusLo, timeSinceLastNoteEvent, pitch, velocity)) {
+                    if (tracks.addNoteOff(statusLo, timeSinceLastNoteEvent, pitch, c_defaultNoteOffVelocity)) {
                         timeSinceLastNoteEvent = 0;
                     }
                 }
@@ -794,8 +862,10 @@ void smf::SmfParser::readFormat0Sequence() {
         throw babelwires::ParseException()
             << "A format 0 Standard MIDI file claims to have " << m_numTracks << " tracks but it should only have 1";
     }
+    const std::span<const babelwires::Byte> trackChunk = readTrackChunk(0);
     TrackSplitter splitTracks(m_channelSetup);
-    readTrack(0, splitTracks, true);
+    readTrack(0, trackChunk, splitTracks, true);
+    splitTracks.buildTracks(getTimebase());
     auto tracks = getSmfSequence().getTrcks0();
     for (int channelNumber = 0; channelNumber < MAX_CHANNELS; ++channelNumber) {
         if (splitTracks.m_channels[channelNumber] != nullptr) {
@@ -804,10 +874,7 @@ void smf::SmfParser::readFormat0Sequence() {
     }
 }
 
-void smf::SmfParser::readFormat1SequenceTrack(MidiTrackAndChannel::Instance& track,
-                                              bool hasMainMetadata) {
-    TrackSplitter splitTrack(m_channelSetup);
-    readTrack(0, splitTrack, hasMainMetadata);
+void smf::SmfParser::setFormat1SequenceTrack(MidiTrackAndChannel::Instance& track, TrackSplitter& splitTrack) {
     // If this is a format 1 track with multiple channels (rare but possible), privilege the
     // channel with the most events.
     int privilegedTrack = -1;
@@ -831,11 +898,32 @@ void smf::SmfParser::readFormat1SequenceTrack(MidiTrackAndChannel::Instance& tra
 }
 
 void smf::SmfParser::readFormat1Sequence() {
+    // All the chunks are located first, so a truncated file is rejected before any work is done.
+    std::vector<std::span<const babelwires::Byte>> trackChunks;
+    trackChunks.reserve(m_numTracks);
+    for (int i = 0; i < m_numTracks; ++i) {
+        trackChunks.emplace_back(readTrackChunk(i));
+    }
+
+    // The MIDI tracks are read in order, since the channel setup carries over from one to the next.
+    // That pass only records the note events, so it is cheap.
+    std::vector<std::unique_ptr<TrackSplitter>> splitTracks;
+    splitTracks.reserve(m_numTracks);
+    for (int i = 0; i < m_numTracks; ++i) {
+        splitTracks.emplace_back(std::make_unique<TrackSplitter>(m_channelSetup));
+        readTrack(i, trackChunks[i], *splitTracks.back(), (i == 0));
+    }
+
+    // Building the tracks is independent for each MIDI track, so it can be done in parallel.
+    const bw_music::Timebase timebase = getTimebase();
+    bw_music::parallelFor(m_numTracks, m_maxThreads,
+                          [&splitTracks, &timebase](std::size_t i) { splitTracks[i]->buildTracks(timebase); });
+
     auto tracks = getSmfSequence().getTrcks1();
     tracks.setSize(m_numTracks);
     for (int i = 0; i < m_numTracks; ++i) {
         auto track = tracks.getEntry(i);
-        readFormat1SequenceTrack(track, (i == 0));
+        setFormat1SequenceTrack(track, *splitTracks[i]);
     }
 }
 
@@ -884,7 +972,34 @@ void smf::SmfParser::onChangeProgram(unsigned int channelNumber) {
 std::unique_ptr<babelwires::ValueTreeRoot> smf::parseSmfSequence(babelwires::DataSource& dataSource,
                                                        const babelwires::ProjectContext& projectContext,
                                                        babelwires::UserLogger& userLogger) {
-    SmfParser parser(dataSource, projectContext, userLogger);
+    std::vector<babelwires::Byte> data;
+    while (!dataSource.isEof()) {
+        data.emplace_back(dataSource.getNextByte());
+    }
+    return parseSmfSequence(data, projectContext, userLogger);
+}
+
+std::unique_ptr<babelwires::ValueTreeRoot> smf::parseSmfSequence(std::span<const babelwires::Byte> data,
+                                                       const babelwires::ProjectContext& projectContext,
+                                                       babelwires::UserLogger& userLogger, unsigned int maxThreads) {
+    SmfParser parser(data, projectContext, userLogger);
+    parser.setMaxThreads(maxThreads);
     parser.parse();
     return parser.getResult();
 }
+
+std::unique_ptr<babelwires::ValueTreeRoot> smf::parseSmfFile(const std::filesystem::path& path,
+                                                   const babelwires::ProjectContext& projectContext,
+                                                   babelwires::UserLogger& userLogger, unsigned int maxThreads) {
+    std::ifstream file(path, std::ios_base::binary | std::ios_base::ate);
+    if (!file) {
+        throw babelwires::IoException() << "Could not open file " << path;
+    }
+    const std::streamsize size = file.tellg();
+    std::vector<babelwires::Byte> data(size);
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data.data()), size)) {
+        throw babelwires::IoException() << "Could not read file " << path;
+    }
+    return parseSmfSequence(data, projectContext, userLogger, maxThreads);
+}
@@ -11,13 +11,16 @@
 #include <Plugins/Smf/Plugin/Percussion/standardPercussionSets.hpp>
 #include <Plugins/Smf/Plugin/smfSequence.hpp>
 
+#include <MusicLib/Types/Track/timebase.hpp>
 #include <MusicLib/musicTypes.hpp>
 
 #include <Common/IO/dataSource.hpp>
 #include <Common/Log/userLogger.hpp>
 
 #include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <span>
 #include <sstream>
 #include <vector>
 
@@ -27,12 +30,19 @@ namespace bw_music {
 
 namespace smf {
 
+    /// Parses the contents of a Standard MIDI File held in a contiguous buffer.
     class SmfParser {
       public:
-        SmfParser(babelwires::DataSource& dataSource, const babelwires::ProjectContext& projectContext,
+        /// The data must outlive the parser.
+        SmfParser(std::span<const babelwires::Byte> data, const babelwires::ProjectContext& projectContext,
                   babelwires::UserLogger& log);
         virtual ~SmfParser();
 
+        /// Some of the work of parsing a format 1 file is shared between up to this many threads.
+        /// The result does not depend on the number of threads. The default of zero means use the available hardware
+        /// threads.
+        void setMaxThreads(unsigned int maxThreads);
+
         void parse();
         std::unique_ptr<babelwires::ValueTreeRoot> getResult() { return std::move(m_result); }
 
@@ -40,8 +50,31 @@ namespace smf {
         SmfSequence::ConstInstance getSmfSequenceConst() const;
         SmfSequence::Instance getSmfSequence();
 
-        babelwires::Byte getNext();
-        babelwires::Byte peekNext();
+        babelwires::Byte getNext() {
+            if (m_next == m_end) {
+                throwTruncated();
+            }
+            return *m_next++;
+        }
+
+        babelwires::Byte peekNext() const {
+            if (m_next == m_end) {
+                throwTruncated();
+            }
+            return *m_next;
+        }
+
+        /// Throw unless at least numBytes bytes remain to be read.
+        void ensureAvailable(std::size_t numBytes) const {
+            if (static_cast<std::size_t>(m_end - m_next) < numBytes) {
+                throwTruncated();
+            }
+        }
+
+        [[noreturn]] void throwTruncated() const;
+
+        /// The position of the next byte, relative to the start of the data.
+        std::size_t getAbsolutePosition() const;
 
         void setGMSpec(GMSpecType::Value spec);
 
@@ -53,15 +86,22 @@ namespace smf {
 
         void readFormat0Sequence();
         void readFormat1Sequence();
-        void readFormat1SequenceTrack(MidiTrackAndChannel::Instance& track, bool hasMainMetadata = false);
 
         MidiMetadata::Instance getMidiMetadata();
 
         class TrackSplitter;
 
-        void readTrack(int trackIndex, TrackSplitter& tracks, bool hasMainMetadata = false);
+        void setFormat1SequenceTrack(MidiTrackAndChannel::Instance& track, TrackSplitter& splitTrack);
+
+        /// The timebase of the ticks in the file.
+        bw_music::Timebase getTimebase() const;
 
-        bw_music::ModelDuration readModelDuration();
+        /// Check the header and length of the next MTrk chunk, and return its contents without copying them.
+        std::span<const babelwires::Byte> readTrackChunk(int trackIndex);
+
+        /// Read the events of an MTrk chunk obtained from readTrackChunk.
+        void readTrack(int trackIndex, std::span<const babelwires::Byte> trackChunk, TrackSplitter& tracks,
+                       bool hasMainMetadata = false);
 
         void readTempoEvent(std::uint32_t tempoValue);
 
@@ -104,8 +144,15 @@ namespace smf {
 
       private:
         const babelwires::ProjectContext& m_projectContext;
-        babelwires::DataSource& m_dataSource;
         babelwires::UserLogger& m_userLogger;
+
+        /// All the data being parsed.
+        std::span<const babelwires::Byte> m_data;
+        /// The next byte to read.
+        const babelwires::Byte* m_next;
+        /// The end of the range which can currently be read: either the end of the data or of the current chunk.
+        const babelwires::Byte* m_end;
+
         std::unique_ptr<babelwires::ValueTreeRoot> m_result;
         std::vector<babelwires::Byte> m_messageBuffer;
 
@@ -114,9 +161,10 @@ namespace smf {
         Format m_sequenceType;
         int m_numTracks;
         int m_division;
+        unsigned int m_maxThreads = 0;
 
         /// Knowledge of how pitches map to percussion instruments.
-        StandardPercussionSets m_standardPercussionSets;
+        const StandardPercussionSets& m_standardPercussionSets;
 
         /// Currently just used to determine which tracks are percussion tracks.
         struct ChannelSetup {
@@ -133,4 +181,18 @@ namespace smf {
                                                               const babelwires::ProjectContext& projectContext,
                                                               babelwires::UserLogger& userLogger);
 
+    /// Parse a Standard MIDI File which is already in memory.
+    /// See SmfParser::setMaxThreads for the meaning of maxThreads.
+    std::unique_ptr<babelwires::ValueTreeRoot> parseSmfSequence(std::span<const babelwires::Byte> data,
+                                                              const babelwires::ProjectContext& projectContext,
+                                                              babelwires::UserLogger& userLogger,
+                                                              unsigned int maxThreads = 0);
+
+    /// Read the file into memory with a single read and parse it.
+    /// See SmfParser::setMaxThreads for the meaning of maxThreads.
+    std::unique_ptr<babelwires::ValueTreeRoot> parseSmfFile(const std::filesystem::path& path,
+                                                          const babelwires::ProjectContext& projectContext,
+                                                          babelwires::UserLogger& userLogger,
+                                                          unsigned int maxThreads = 0);
+
 } // namespace smf
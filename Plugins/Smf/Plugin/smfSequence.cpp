@@ -7,6 +7,8 @@
  **/
 #include <Plugins/Smf/Plugin/smfSequence.hpp>
 
+#include <MusicLib/Types/Track/track.hpp>
+
 #include <Common/Identifiers/registeredIdentifier.hpp>
 
 namespace {
@@ -23,4 +25,37 @@ smf::SmfSequence::SmfSequence()
             {"SMF0"}},
            {BW_SHORT_ID("Trcks1", "Tracks", "38ae4e20-1468-4dce-890b-981454e6dbe0"),
             MidiTrackAndChannelArray::getThisType(),
-            {"SMF1"}}}) {}
\ No newline at end of file
+            {"SMF1"}}}) {}
+
+int smf::transformAllTracks(SmfSequence::Instance smfSequence,
+                            const std::function<bw_music::Track(const bw_music::Track&)>& function) {
+    int numTracks = 0;
+    if (smfSequence.getInstanceType().getIndexOfTag(smfSequence.getSelectedTag()) == 0) {
+        auto tracks = smfSequence.getTrcks0();
+        for (unsigned int c = 0; c < 16; ++c) {
+            if (auto track = tracks.tryGetTrack(c)) {
+                bw_music::Track newTrack = function(track->get());
+                tracks.getTrack(c).set(std::move(newTrack));
+                ++numTracks;
+            }
+        }
+    } else {
+        auto tracks = smfSequence.getTrcks1();
+        for (int i = 0; i < tracks.getSize(); ++i) {
+            auto trackAndChannel = tracks.getEntry(i);
+            auto track = trackAndChannel.getTrack();
+            bw_music::Track newTrack = function(track.get());
+            track.set(std::move(newTrack));
+            ++numTracks;
+            for (unsigned int c = 0; c < 16; ++c) {
+                if (auto extraTrack = trackAndChannel.tryGetTrack(c)) {
+                    // The track is already active, so this just provides mutable access to it.
+                    bw_music::Track newExtraTrack = function(extraTrack->get());
+                    trackAndChannel.activateAndGetTrack(c).set(std::move(newExtraTrack));
+                    ++numTracks;
+                }
+            }
+        }
+    }
+    return numTracks;
+}
@@ -16,6 +16,8 @@
 
 #include <BabelWiresLib/ValueTree/valueTreeNode.hpp>
 
+#include <functional>
+
 namespace bw_music {
     class Track;
 } // namespace bw_music
@@ -34,4 +36,9 @@ namespace smf {
         DECLARE_INSTANCE_ARRAY_FIELD(Trcks1, MidiTrackAndChannel);
         DECLARE_INSTANCE_END()
     };
+
+    /// Replace every track of the sequence by the result of applying the function to it. In format 1 sequences,
+    /// this includes the tracks of the other channels of each track chunk. Returns the number of tracks.
+    int transformAllTracks(SmfSequence::Instance smfSequence,
+                           const std::function<bw_music::Track(const bw_music::Track&)>& function);
 }
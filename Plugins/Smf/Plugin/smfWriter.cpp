@@ -11,11 +11,12 @@
 #include <Plugins/Smf/Plugin/Percussion/gmPercussionSet.hpp>
 #include <Plugins/Smf/Plugin/gmSpec.hpp>
 #include <Plugins/Smf/Plugin/midiTrackAndChannel.hpp>
+#include <Plugins/Smf/Plugin/smfCommon.hpp>
 
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
 #include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
-#include <MusicLib/Utilities/filteredTrackIterator.hpp>
+#include <MusicLib/Utilities/mergingTraverser.hpp>
 #include <MusicLib/Utilities/musicUtilities.hpp>
-#include <MusicLib/Utilities/trackTraverser.hpp>
 
 #include <BabelWiresLib/Project/projectContext.hpp>
 #include <BabelWiresLib/TypeSystem/typeSystem.hpp>
@@ -24,13 +25,26 @@
 #include <Common/Log/userLogger.hpp>
 
 #include <algorithm>
+#include <numeric>
 #include <set>
-#include <sstream>
 
 namespace {
     // See page 237 of the SC-8850 English manual for the part to block conversion.
     // We will always use the default part mapping, where parts correspond to midi channels.
     const std::array<unsigned int, 16> s_gsChannelToBlockMapping{1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 10, 11, 12, 13, 14, 15};
+
+    /// The top bit of the division field in the header selects SMPTE time.
+    constexpr int c_maxDivision = 0x7FFF;
+
+    /// This represents triplets, quintuplets and notes down to 256ths exactly. When exact times would need too
+    /// large a division, the largest multiple of this which fits is used.
+    constexpr int c_fallbackDivisionBase = 960;
+
+    /// Round the quotient to the nearest integer. The numerator must not be negative and the denominator must be
+    /// positive.
+    std::int64_t divideAndRound(std::int64_t numerator, std::int64_t denominator) {
+        return ((2 * numerator) + denominator) / (2 * denominator);
+    }
 } // namespace
 
 smf::SmfWriter::SmfWriter(const babelwires::ProjectContext& projectContext, babelwires::UserLogger& userLogger,
@@ -39,56 +53,65 @@ smf::SmfWriter::SmfWriter(const babelwires::ProjectContext& projectContext, babe
     , m_userLogger(userLogger)
     , m_smfFeature(sequence)
     , m_ostream(ostream)
-    , m_os(&m_ostream)
     , m_division(256)
-    , m_standardPercussionSets(projectContext) {}
+    , m_standardPercussionSets(StandardPercussionSets::get(projectContext)) {}
+
+void smf::SmfWriter::setUseRunningStatus(bool useRunningStatus) {
+    m_useRunningStatus = useRunningStatus;
+}
+
+void smf::SmfWriter::setTargetDivision(int division) {
+    m_targetDivision = std::clamp(division, 1, c_maxDivision);
+    if (m_targetDivision != division) {
+        m_userLogger.logWarning() << "The division " << division << " is out of range, so " << m_targetDivision
+                                  << " ticks per quarter note will be used";
+    }
+}
+
+void smf::SmfWriter::writeBytes(const char* bytes, std::size_t numBytes) {
+    m_buffer.insert(m_buffer.end(), bytes, bytes + numBytes);
+}
 
 void smf::SmfWriter::writeUint16(std::uint16_t i) {
-    m_os->put(i >> 8);
-    m_os->put(i & 255);
+    writeByte(i >> 8);
+    writeByte(i & 255);
 }
 
 void smf::SmfWriter::writeUint24(std::uint32_t i) {
     assert((i < (1 << 24)) && "Value cannot be represented in 24 bits");
-    m_os->put(i >> 16);
-    m_os->put((i >> 8) & 255);
-    m_os->put(i & 255);
+    writeByte(i >> 16);
+    writeByte((i >> 8) & 255);
+    writeByte(i & 255);
 }
 
 void smf::SmfWriter::writeUint32(std::uint32_t i) {
-    m_os->put(i >> 24);
-    m_os->put((i >> 16) & 255);
-    m_os->put((i >> 8) & 255);
-    m_os->put(i & 255);
+    writeByte(i >> 24);
+    writeByte((i >> 16) & 255);
+    writeByte((i >> 8) & 255);
+    writeByte(i & 255);
 }
 
 void smf::SmfWriter::writeVariableLengthQuantity(std::uint32_t i) {
     assert((i <= 0x0fffffff) && "Value is too big for a variable-lengths quantity");
 
-    if (const std::uint32_t b0 = ((i >> 21) & 0x7f)) {
-        m_os->put(b0 | 0x80);
+    // Once a group has been written, all the lower groups must be written, even if they are zero.
+    if (i >= (1 << 21)) {
+        writeByte(((i >> 21) & 0x7f) | 0x80);
     }
-    if (const std::uint32_t b1 = ((i >> 14) & 0x7f)) {
-        m_os->put(b1 | 0x80);
+    if (i >= (1 << 14)) {
+        writeByte(((i >> 14) & 0x7f) | 0x80);
     }
-    if (const std::uint32_t b2 = ((i >> 7) & 0x7f)) {
-        m_os->put(b2 | 0x80);
+    if (i >= (1 << 7)) {
+        writeByte(((i >> 7) & 0x7f) | 0x80);
     }
-    const std::uint32_t b3 = i & 0x7f;
-    m_os->put(b3);
-}
-
-void smf::SmfWriter::writeModelDuration(const bw_music::ModelDuration& d) {
-    // TODO: Quantize if this isn't exact.
-    const int numDivisions = (d.getNumerator() * m_division * 4) / (d.getDenominator());
-    writeVariableLengthQuantity(numDivisions);
+    writeByte(i & 0x7f);
 }
 
 void smf::SmfWriter::writeTempoEvent(int bpm) {
-    m_os->put(0x00u);
-    m_os->put(0xffu);
-    m_os->put(0x51u);
-    m_os->put(0x03u);
+    writeByte(0x00u);
+    writeByte(0xffu);
+    writeByte(0x51u);
+    writeByte(0x03u);
 
     const int d = 60'000'000 / bpm;
 
@@ -98,13 +121,13 @@ void smf::SmfWriter::writeTempoEvent(int bpm) {
 void smf::SmfWriter::writeTextMetaEvent(int type, std::string text) {
     assert((0 <= type) && (type <= 15) && "Type is out-of-range.");
     babelwires::Byte t = type;
-    m_os->put(0x00u);
-    m_os->put(0xffu);
-    m_os->put(t);
+    writeByte(0x00u);
+    writeByte(0xffu);
+    writeByte(t);
     writeVariableLengthQuantity(text.length());
 
     // TODO assert text is ASCII.
-    *m_os << text;
+    writeBytes(text.data(), text.length());
 }
 
 smf::SmfSequence::ConstInstance smf::SmfWriter::getSmfSequenceConst() const {
@@ -114,29 +137,46 @@ smf::SmfSequence::ConstInstance smf::SmfWriter::getSmfSequenceConst() const {
 void smf::SmfWriter::writeHeaderChunk(unsigned int numTracks) {
     const auto& smfType = getSmfSequenceConst();
 
-    assert((m_division < (2 << 15)) && "division is too large");
+    assert((m_division > 0) && (m_division <= c_maxDivision) && "division is out of range");
 
     const unsigned int tagIndex = smfType.getInstanceType().getIndexOfTag(smfType.getSelectedTag());
 
-    m_os->write("MThd", 4);
+    writeBytes("MThd", 4);
     writeUint32(6);
     writeUint16(tagIndex);
     writeUint16((tagIndex == 0) ? 1 : numTracks);
 
-    {
-        int division = 1;
-        applyToAllTracks([&division](unsigned int channelNumber, const bw_music::Track& track) {
-            division = babelwires::lcm(division, bw_music::getMinimumDenominator(track));
-        });
-        m_division = division;
-    }
-
     // 0 in high-bit implies metrical.
     writeUint16(m_division);
 }
 
+void smf::SmfWriter::writeStatusByte(babelwires::Byte statusByte) {
+    if (!m_useRunningStatus || (statusByte != m_runningStatus)) {
+        writeByte(statusByte);
+        m_runningStatus = statusByte;
+    }
+}
+
+void smf::SmfWriter::writeNoteOn(int channelNumber, bw_music::Pitch pitch, bw_music::Velocity velocity) {
+    writeStatusByte(0b10010000 | channelNumber);
+    writeByte(pitch);
+    writeByte(velocity);
+}
+
+void smf::SmfWriter::writeNoteOff(int channelNumber, bw_music::Pitch pitch, bw_music::Velocity velocity) {
+    if (m_useRunningStatus && (velocity == c_defaultNoteOffVelocity)) {
+        writeStatusByte(0b10010000 | channelNumber);
+        writeByte(pitch);
+        writeByte(0);
+    } else {
+        writeStatusByte(0b10000000 | channelNumber);
+        writeByte(pitch);
+        writeByte(velocity);
+    }
+}
+
 smf::SmfWriter::WriteTrackEventResult smf::SmfWriter::writeTrackEvent(int channelNumber,
-                                                                      bw_music::ModelDuration timeSinceLastEvent,
+                                                                      std::uint32_t deltaTime,
                                                                       const bw_music::TrackEvent& e) {
     assert(channelNumber >= 0);
     assert(channelNumber <= 15);
@@ -145,20 +185,16 @@ smf::SmfWriter::WriteTrackEventResult smf::SmfWriter::writeTrackEvent(int channe
             m_channelSetup[channelNumber].m_kitIfPercussion) {
         if (const bw_music::PercussionOnEvent* percussionOn = e.as<bw_music::PercussionOnEvent>()) {
             if (auto maybePitch = kitIfPercussion->tryGetPitchFromInstrument(percussionOn->getInstrument())) {
-                writeModelDuration(timeSinceLastEvent);
-                m_os->put(0b10010000 | channelNumber);
-                m_os->put(*maybePitch);
-                m_os->put(percussionOn->getVelocity());
+                writeVariableLengthQuantity(deltaTime);
+                writeNoteOn(channelNumber, *maybePitch, percussionOn->getVelocity());
                 return WriteTrackEventResult::Written;
             } else {
                 return WriteTrackEventResult::NotInPercussionSet;
             }
         } else if (const bw_music::PercussionOffEvent* percussionOff = e.as<bw_music::PercussionOffEvent>()) {
             if (auto maybePitch = kitIfPercussion->tryGetPitchFromInstrument(percussionOff->getInstrument())) {
-                writeModelDuration(timeSinceLastEvent);
-                m_os->put(0b10000000 | channelNumber);
-                m_os->put(*maybePitch);
-                m_os->put(percussionOff->getVelocity());
+                writeVariableLengthQuantity(deltaTime);
+                writeNoteOff(channelNumber, *maybePitch, percussionOff->getVelocity());
                 return WriteTrackEventResult::Written;
             } else {
                 return WriteTrackEventResult::NotInPercussionSet;
@@ -166,86 +202,59 @@ smf::SmfWriter::WriteTrackEventResult smf::SmfWriter::writeTrackEvent(int channe
         }
     } else {
         if (const bw_music::NoteOnEvent* noteOn = e.as<bw_music::NoteOnEvent>()) {
-            writeModelDuration(timeSinceLastEvent);
-            m_os->put(0b10010000 | channelNumber);
-            m_os->put(noteOn->m_pitch);
-            m_os->put(noteOn->m_velocity);
+            writeVariableLengthQuantity(deltaTime);
+            writeNoteOn(channelNumber, noteOn->m_pitch, noteOn->m_velocity);
             return WriteTrackEventResult::Written;
         } else if (const bw_music::NoteOffEvent* noteOff = e.as<bw_music::NoteOffEvent>()) {
-            writeModelDuration(timeSinceLastEvent);
-            m_os->put(0b10000000 | channelNumber);
-            m_os->put(noteOff->m_pitch);
-            m_os->put(noteOff->m_velocity);
+            writeVariableLengthQuantity(deltaTime);
+            writeNoteOff(channelNumber, noteOff->m_pitch, noteOff->m_velocity);
             return WriteTrackEventResult::Written;
         }
     }
     return WriteTrackEventResult::WrongCategory;
 }
 
-namespace {
-    struct NoteTrackIterator : bw_music::FilteredTrackIterator<> {
-        bool isEventOfInterest(const bw_music::TrackEvent& event) const { return event.as<bw_music::NoteEvent>(); }
-    };
-
-    struct PercussionTrackIterator : bw_music::FilteredTrackIterator<> {
-        bool isEventOfInterest(const bw_music::TrackEvent& event) const {
-            return event.as<bw_music::PercussionEvent>();
-        }
-    };
-
-} // namespace
-
 void smf::SmfWriter::writeNotes(const std::vector<ChannelAndTrack>& tracks) {
-    const int numTracks = tracks.size();
-
-    bw_music::ModelDuration trackDuration = 0;
-
-    // TODO Use the mergeFunction to multiplex the channels.
-
-    std::vector<bw_music::TrackTraverser<bw_music::FilteredTrackIterator<bw_music::TrackEvent>>> traversers;
-
-    for (int i = 0; i < numTracks; ++i) {
-        const bw_music::Track& track = *std::get<1>(tracks[i]);
-        traversers.emplace_back(track, bw_music::iterateOver<bw_music::TrackEvent>(track));
-        traversers.back().leastUpperBoundDuration(trackDuration);
+    std::vector<const bw_music::Track*> tracksToMerge;
+    tracksToMerge.reserve(tracks.size());
+    for (const auto& channelAndTrack : tracks) {
+        tracksToMerge.emplace_back(std::get<1>(channelAndTrack));
     }
 
-    bw_music::ModelDuration timeSinceStart = 0;
-    bw_music::ModelDuration timeOfLastEvent = 0;
-    while (timeSinceStart < trackDuration) {
-        bw_music::ModelDuration timeToNextEvent = trackDuration - timeSinceStart;
-        for (int i = 0; i < numTracks; ++i) {
-            traversers[i].greatestLowerBoundNextEvent(timeToNextEvent);
+    bw_music::MergingTraverser traverser(tracksToMerge);
+    const bw_music::Timebase& timebase = traverser.getTimebase();
+
+    // Only channel messages are written below, so running status can start with the first of them.
+    m_runningStatus = 0;
+
+    // Each event time is rounded from its exact position, rather than rounding the time since the last event, so
+    // rounding errors do not accumulate.
+    const std::int64_t divisionsPerWholeNote = 4 * m_division;
+    const std::int64_t ticksPerWholeNote = timebase.getTicksPerWholeNote();
+    std::int64_t divisionsOfLastEvent = 0;
+    traverser.visitEvents([this, &tracks, divisionsPerWholeNote, ticksPerWholeNote, &divisionsOfLastEvent](
+                              int trackIndex, bw_music::Ticks time, const bw_music::Track::const_iterator& it) {
+        const unsigned int channelNumber = std::get<0>(tracks[trackIndex]);
+        const std::int64_t divisions = divideAndRound(time * divisionsPerWholeNote, ticksPerWholeNote);
+        const WriteTrackEventResult result =
+            writeTrackEvent(channelNumber, static_cast<std::uint32_t>(divisions - divisionsOfLastEvent), *it);
+        if (result == WriteTrackEventResult::Written) {
+            divisionsOfLastEvent = divisions;
+        } else {
+            // TODO Warn user about events which could not be written.
+            m_userLogger.logWarning() << "Event could not be written";
         }
-
-        bool isFirstEventAtThisTime = true;
-        for (int i = 0; i < numTracks; ++i) {
-            const unsigned int channelNumber = std::get<0>(tracks[i]);
-            traversers[i].advance(timeToNextEvent, [this, &isFirstEventAtThisTime, &timeToNextEvent, &timeOfLastEvent,
-                                                    &timeSinceStart, channelNumber](const bw_music::TrackEvent& event) {
-                const bw_music::ModelDuration timeToThisEvent = isFirstEventAtThisTime ? timeToNextEvent : 0;
-                const WriteTrackEventResult result = writeTrackEvent(channelNumber, timeToThisEvent, event);
-                if (result == WriteTrackEventResult::Written) {
-                    timeOfLastEvent = timeSinceStart + timeToNextEvent;
-                    isFirstEventAtThisTime = false;
-                } else {
-                    // TODO Warn user about events which could not be written.
-                    m_userLogger.logWarning() << "Event could not be written";
-                }
-            });
-        }
-
-        timeSinceStart += timeToNextEvent;
-    }
+    });
 
     // End of track event.
-    writeModelDuration(trackDuration - timeOfLastEvent);
+    const bw_music::ModelDuration duration = traverser.getDuration();
+    writeVariableLengthQuantity(
+        divideAndRound(duration.getNumerator() * divisionsPerWholeNote, duration.getDenominator()) -
+        divisionsOfLastEvent);
 }
 
 template <std::size_t N> void smf::SmfWriter::writeMessage(const std::array<std::uint8_t, N>& message) {
-    for (int i = 0; i < message.size(); ++i) {
-        m_os->put(message[i]);
-    }
+    m_buffer.insert(m_buffer.end(), message.begin(), message.end());
 }
 
 void smf::SmfWriter::writeGlobalSetup() {
@@ -253,20 +262,20 @@ void smf::SmfWriter::writeGlobalSetup() {
 
     switch (metadata.getSpec().get()) {
         case GMSpecType::Value::GM:
-            writeModelDuration(0);
+            writeVariableLengthQuantity(0);
             writeMessage(std::array<std::uint8_t, 7>{0b11110000, 0x05, 0x7E, 0x7F, 0x09, 0x01, 0xF7});
             break;
         case GMSpecType::Value::GM2:
-            writeModelDuration(0);
+            writeVariableLengthQuantity(0);
             writeMessage(std::array<std::uint8_t, 7>{0b11110000, 0x05, 0x7E, 0x7F, 0x09, 0x03, 0xF7});
             break;
         case GMSpecType::Value::GS:
-            writeModelDuration(0);
+            writeVariableLengthQuantity(0);
             writeMessage(std::array<std::uint8_t, 12>{0b11110000, 0x0A, 0x41, 0x10, 0x42, 0x12, 0x40, 0x00, 0x7F, 0x00,
                                                       0x41, 0xF7});
             break;
         case GMSpecType::Value::XG:
-            writeModelDuration(0);
+            writeVariableLengthQuantity(0);
             writeMessage(
                 std::array<std::uint8_t, 10>{0b11110000, 0x08, 0x43, 0x10, 0x4C, 0x00, 0x00, 0x7E, 0x00, 0xF7});
         default:
@@ -290,10 +299,14 @@ void smf::SmfWriter::writeGlobalSetup() {
     }
 }
 
-void smf::SmfWriter::writeTrack(const std::vector<ChannelAndTrack>& tracks, bool includeGlobalSetup) {
-    std::ostream* oldStream = m_os;
-    std::ostringstream tempStream;
-    m_os = &tempStream;
+void smf::SmfWriter::writeTrack(const TrackChunk& chunk, bool includeGlobalSetup) {
+    const std::vector<ChannelAndTrack>& tracks = chunk.m_tracks;
+    m_buffer.reserve(m_buffer.size() + chunk.m_estimatedSize);
+
+    writeBytes("MTrk", 4);
+    // The length is not known yet, so reserve space for it.
+    const std::size_t lengthOffset = m_buffer.size();
+    writeUint32(0);
 
     if (includeGlobalSetup) {
         writeGlobalSetup();
@@ -305,31 +318,29 @@ void smf::SmfWriter::writeTrack(const std::vector<ChannelAndTrack>& tracks, bool
         const unsigned int channelNumber = std::get<0>(tracks[i]);
         ChannelSetup& channelSetup = m_channelSetup[channelNumber];
         if (!channelSetup.m_setupWritten) {
-            const std::optional<StandardPercussionSets::ChannelSetupInfo> info =
-                m_standardPercussionSets.getChannelSetupInfoFromPercussionSet(channelSetup.m_kitIfPercussion,
-                                                                              channelNumber);
+            const std::optional<StandardPercussionSets::ChannelSetupInfo>& info = channelSetup.m_setupInfo;
             if (info) {
                 if (gmSpec == GMSpecType::Value::GS) {
                     // Set GS "Use For Rhythm Part"
-                    writeModelDuration(0);
+                    writeVariableLengthQuantity(0);
                     const std::uint8_t block = 0x10 | s_gsChannelToBlockMapping[channelNumber];
                     const std::uint8_t checksum = (0x80 - ((0x40 + block + 0x15 + info->m_gsPartMode) % 0x80)) % 0x80;
                     writeMessage(std::array<std::uint8_t, 12>{0b11110000, 0x0A, 0x41, 0x10, 0x42, 0x12, 0x40, block,
                                                               0x15, info->m_gsPartMode, checksum, 0xF7});
                 } else {
                     // Bank select MSB
-                    writeModelDuration(0);
+                    writeVariableLengthQuantity(0);
                     writeMessage(std::array<std::uint8_t, 3>{static_cast<std::uint8_t>(0b10110000 | channelNumber),
                                                              0x00, info->m_bankMSB});
 
                     // Bank select LSB
-                    writeModelDuration(0);
+                    writeVariableLengthQuantity(0);
                     writeMessage(std::array<std::uint8_t, 3>{static_cast<std::uint8_t>(0b10110000 | channelNumber),
                                                              0x20, info->m_bankLSB});
                 }
 
                 // Program change.
-                writeModelDuration(0);
+                writeVariableLengthQuantity(0);
                 writeMessage(std::array<std::uint8_t, 2>{static_cast<std::uint8_t>(0b11000000 | channelNumber),
                                                          info->m_program});
             }
@@ -340,100 +351,128 @@ void smf::SmfWriter::writeTrack(const std::vector<ChannelAndTrack>& tracks, bool
     writeNotes(tracks);
 
     // End of track.
-    m_os->put(0xffu);
-    m_os->put(0x2Fu);
-    m_os->put(0x00u);
-
-    m_os = oldStream;
-    m_os->write("MTrk", 4);
-    writeUint32(static_cast<std::uint32_t>(tempStream.tellp()));
-    m_os->write(tempStream.str().data(), tempStream.tellp());
-}
+    writeByte(0xffu);
+    writeByte(0x2Fu);
+    writeByte(0x00u);
 
-void smf::SmfWriter::setUpPercussionKit(const std::unordered_set<babelwires::ShortId>& instrumentsInUse,
-                                        int channelNumber) {
-    const GMSpecType::Value gmSpec = getSmfSequenceConst().getMeta().getSpec().get();
-    std::unordered_set<babelwires::ShortId> excludedInstruments;
-    m_channelSetup[channelNumber].m_kitIfPercussion =
-        m_standardPercussionSets.getBestPercussionSet(gmSpec, channelNumber, instrumentsInUse, excludedInstruments);
-    if (!excludedInstruments.empty()) {
-        m_userLogger.logWarning() << "Percussion events for " << excludedInstruments.size()
-                                  << " instruments could not be represented in channel " << channelNumber;
-    }
-}
+    const std::uint32_t trackLength = m_buffer.size() - lengthOffset - 4;
+    m_buffer[lengthOffset] = trackLength >> 24;
+    m_buffer[lengthOffset + 1] = (trackLength >> 16) & 255;
+    m_buffer[lengthOffset + 2] = (trackLength >> 8) & 255;
+    m_buffer[lengthOffset + 3] = trackLength & 255;
 
-namespace {
-    void getPercussionInstrumentsInUse(const bw_music::Track& track,
-                                       std::unordered_set<babelwires::ShortId>& instrumentsInUse) {
-        for (auto it : bw_music::iterateOver<bw_music::PercussionEvent>(track)) {
-            instrumentsInUse.insert(it.getInstrument());
-        }
-    }
+    flushBuffer();
+}
 
-} // namespace
+void smf::SmfWriter::flushBuffer() {
+    m_ostream.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+    m_buffer.clear();
+}
 
-void smf::SmfWriter::setUpPercussionSets() {
-    std::array<std::unordered_set<babelwires::ShortId>, 16> instrumentsInUse;
-    applyToAllTracks([this, &instrumentsInUse](unsigned int channelNumber, const bw_music::Track& track) {
-        getPercussionInstrumentsInUse(track, instrumentsInUse[channelNumber]);
-    });
+void smf::SmfWriter::setUpPercussionSets(
+    const std::array<std::unordered_set<babelwires::ShortId>, 16>& instrumentsInUse) {
+    const GMSpecType::Value gmSpec = getSmfSequenceConst().getMeta().getSpec().get();
+    const auto assignments = m_standardPercussionSets.assignPercussionSets(gmSpec, instrumentsInUse);
     for (int i = 0; i < 16; ++i) {
-        setUpPercussionKit(instrumentsInUse[i], i);
+        m_channelSetup[i].m_kitIfPercussion = assignments[i].m_percussionSet;
+        m_channelSetup[i].m_setupInfo = assignments[i].m_channelSetupInfo;
+        if (assignments[i].m_numExcludedInstruments > 0) {
+            m_userLogger.logWarning() << "Percussion events for " << assignments[i].m_numExcludedInstruments
+                                      << " instruments could not be represented in channel " << i;
+        }
     }
 }
 
-void smf::SmfWriter::applyToAllTracks(std::function<void(unsigned int, const bw_music::Track&)> func) {
-    const auto& smfType = getSmfSequenceConst();
-    if (smfType.getInstanceType().getIndexOfTag(smfType.getSelectedTag()) == 0) {
-        const auto& tracks = smfType.getTrcks0();
-        for (unsigned int c = 0; c < 16; ++c) {
-            if (auto track = tracks.tryGetTrack(c)) {
-                func(c, track->get());
+namespace {
+    /// A delta-time of up to two bytes and a three byte message.
+    constexpr std::size_t c_estimatedBytesPerEvent = 5;
+
+    /// Room for the chunk header, the set-up messages and the end of track event.
+    constexpr std::size_t c_estimatedChunkOverhead = 64;
+
+    /// The number of events which might be written as MIDI messages.
+    std::size_t getNumEventsToWrite(const bw_music::Track::EventSummary& eventSummary) {
+        std::size_t numEvents = 0;
+        for (auto category : {bw_music::NoteEvent::s_noteEventCategory,
+                              bw_music::PercussionEvent::s_percussionEventCategory}) {
+            const auto it = eventSummary.m_numEventsByCategory.find(category);
+            if (it != eventSummary.m_numEventsByCategory.end()) {
+                numEvents += it->second;
             }
         }
-    } else {
-        const auto& tracks = smfType.getTrcks1();
-        const int numTracks = tracks.getSize();
-        for (int i = 0; i < numTracks; ++i) {
-            auto entry = tracks.getEntry(i);
-            func(entry.getChan().get(), entry.getTrack().get());
-        }
+        return numEvents;
     }
-}
-
-void smf::SmfWriter::write() {
-    setUpPercussionSets();
+} // namespace
 
-    std::vector<ChannelAndTrack> channelAndTrackValues;
+void smf::SmfWriter::analyzeTracks() {
+    m_chunks.clear();
 
     const auto& smfType = getSmfSequenceConst();
-
     if (smfType.getInstanceType().getIndexOfTag(smfType.getSelectedTag()) == 0) {
+        // A format 0 file always has exactly one chunk.
+        TrackChunk& chunk = m_chunks.emplace_back();
         const auto& tracks = smfType.getTrcks0();
         for (unsigned int c = 0; c < 16; ++c) {
             if (auto track = tracks.tryGetTrack(c)) {
-                channelAndTrackValues.emplace_back(ChannelAndTrack{c, &track->get()});
+                chunk.m_tracks.emplace_back(ChannelAndTrack{c, &track->get()});
             }
         }
-        writeHeaderChunk(channelAndTrackValues.size());
-        writeTrack(channelAndTrackValues, true);
     } else {
         const auto& tracks = smfType.getTrcks1();
         const int numTracks = tracks.getSize();
-        writeHeaderChunk(numTracks);
+        m_chunks.reserve(numTracks);
         for (int i = 0; i < numTracks; ++i) {
-            channelAndTrackValues.clear();
+            TrackChunk& chunk = m_chunks.emplace_back();
             auto trackAndChannel = tracks.getEntry(i);
-            channelAndTrackValues.emplace_back(
+            chunk.m_tracks.emplace_back(
                 ChannelAndTrack{trackAndChannel.getChan().get(), &trackAndChannel.getTrack().get()});
             for (unsigned int c = 0; c < 16; ++c) {
                 if (auto extraTrack = trackAndChannel.tryGetTrack(c)) {
-                    channelAndTrackValues.emplace_back(ChannelAndTrack{c, &extraTrack->get()});
+                    chunk.m_tracks.emplace_back(ChannelAndTrack{c, &extraTrack->get()});
                 }
             }
-            writeTrack(channelAndTrackValues, (i == 0));
         }
     }
+
+    std::array<std::unordered_set<babelwires::ShortId>, 16> instrumentsInUse;
+    // The denominators are in whole notes but the division is per quarter note, so a denominator D needs a division
+    // of D / gcd(D, 4). Stop refining the division once it is too large to be used.
+    std::int64_t exactDivision = 1;
+    for (TrackChunk& chunk : m_chunks) {
+        std::size_t numEvents = 0;
+        for (const auto& [channelNumber, track] : chunk.m_tracks) {
+            const bw_music::Track::EventSummary& eventSummary = track->getEventSummary();
+            instrumentsInUse[channelNumber].insert(eventSummary.m_percussionInstruments.begin(),
+                                                   eventSummary.m_percussionInstruments.end());
+            numEvents += getNumEventsToWrite(eventSummary);
+            if ((m_targetDivision == 0) && (exactDivision <= c_maxDivision)) {
+                const std::int64_t denominator = bw_music::getMinimumDenominator(*track);
+                exactDivision = std::lcm(exactDivision, denominator / std::gcd(denominator, std::int64_t{4}));
+            }
+        }
+        chunk.m_estimatedSize = c_estimatedChunkOverhead + numEvents * c_estimatedBytesPerEvent;
+    }
+    if (m_targetDivision != 0) {
+        m_division = m_targetDivision;
+    } else if (exactDivision <= c_maxDivision) {
+        m_division = static_cast<int>(exactDivision);
+    } else {
+        m_division = (c_maxDivision / c_fallbackDivisionBase) * c_fallbackDivisionBase;
+        m_userLogger.logWarning() << "Event times cannot be represented exactly, so they will be quantized to "
+                                  << m_division << " ticks per quarter note";
+    }
+
+    setUpPercussionSets(instrumentsInUse);
+}
+
+void smf::SmfWriter::write() {
+    analyzeTracks();
+
+    writeHeaderChunk(m_chunks.size());
+    flushBuffer();
+    for (std::size_t i = 0; i < m_chunks.size(); ++i) {
+        writeTrack(m_chunks[i], (i == 0));
+    }
 }
 
 void smf::writeToSmf(const babelwires::ProjectContext& projectContext, babelwires::UserLogger& userLogger,
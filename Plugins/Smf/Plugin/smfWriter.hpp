@@ -14,6 +14,7 @@
 
 #include <cstdint>
 #include <ostream>
+#include <vector>
 
 namespace babelwires {
     struct UserLogger;
@@ -31,21 +32,37 @@ namespace smf {
         SmfWriter(const babelwires::ProjectContext& projectContext, babelwires::UserLogger& userLogger,
                   const babelwires::ValueTreeRoot& sequence, std::ostream& output);
 
+        /// Omit status bytes which repeat the previous one (running status), and write note-offs with the default
+        /// velocity as note-ons with velocity 0, so they can share a status byte with the note-ons.
+        /// This makes dense files about a third smaller. It is off by default.
+        void setUseRunningStatus(bool useRunningStatus);
+
+        /// Quantize event times to the given number of ticks per quarter note. Values outside 1..0x7FFF are clamped
+        /// to that range, with a warning.
+        /// By default, the division is chosen so that event times are exact, unless that would need a division
+        /// larger than 0x7FFF, in which case they are quantized to the finest division available.
+        void setTargetDivision(int division);
+
         void write();
 
       protected:
         SmfSequence::ConstInstance getSmfSequenceConst() const;
 
+        void writeByte(babelwires::Byte b) { m_buffer.push_back(b); }
+        void writeBytes(const char* bytes, std::size_t numBytes);
         void writeUint16(std::uint16_t i);
         void writeUint24(std::uint32_t i);
         void writeUint32(std::uint32_t i);
         void writeVariableLengthQuantity(std::uint32_t i);
-        void writeModelDuration(const bw_music::ModelDuration& d);
+
+        /// Write the status byte of a channel message, unless running status allows it to be omitted.
+        void writeStatusByte(babelwires::Byte statusByte);
+        void writeNoteOn(int channelNumber, bw_music::Pitch pitch, bw_music::Velocity velocity);
+        void writeNoteOff(int channelNumber, bw_music::Pitch pitch, bw_music::Velocity velocity);
 
         /// Returns true if the event was written.
         enum class WriteTrackEventResult { Written, WrongCategory, NotInPercussionSet };
-        WriteTrackEventResult writeTrackEvent(int channelNumber, bw_music::ModelDuration timeSinceLastEvent,
-                                              const bw_music::TrackEvent& e);
+        WriteTrackEventResult writeTrackEvent(int channelNumber, std::uint32_t deltaTime, const bw_music::TrackEvent& e);
 
         void writeTempoEvent(int bpm);
 
@@ -54,23 +71,34 @@ namespace smf {
 
         using ChannelAndTrack = std::tuple<unsigned int, const bw_music::Track*>;
 
-        void applyToAllTracks(std::function<void(unsigned int, const bw_music::Track&)> function);
+        /// The tracks which are written together in one track chunk.
+        struct TrackChunk {
+            std::vector<ChannelAndTrack> m_tracks;
+            /// Enough space for the chunk in most cases, so the buffer rarely grows while it is written.
+            std::size_t m_estimatedSize = 0;
+        };
+
+        /// Gather everything needed before writing starts from the summaries of the tracks, visiting each once.
+        /// This determines the chunks, the division and the percussion kits.
+        void analyzeTracks();
 
         void writeNotes(const std::vector<ChannelAndTrack>& tracks);
 
         void writeHeaderChunk(unsigned int numTracks);
 
-        /// Write the events for the given track.
-        void writeTrack(const std::vector<ChannelAndTrack>& tracks, bool includeGlobalSetup);
+        /// Write the events for the given chunk.
+        /// The chunk is built in the buffer and its length is filled in afterwards, so it is output with one write.
+        void writeTrack(const TrackChunk& chunk, bool includeGlobalSetup);
+
+        /// Write the contents of the buffer to the output stream and clear it.
+        void flushBuffer();
 
         /// Write non-channel-specific setup information.
         void writeGlobalSetup();
 
-        /// Determine from the events in the tracks what percussion kit (allowed for the channelNumber) includes the
-        /// largest number of the events.
-        void setUpPercussionKit(const std::unordered_set<babelwires::ShortId>& instrumentsInUse, int channelNumber);
-
-        void setUpPercussionSets();
+        /// Determine from the instruments in use which channels should be percussion channels and which kits they
+        /// should use, so that the most instruments are represented.
+        void setUpPercussionSets(const std::array<std::unordered_set<babelwires::ShortId>, 16>& instrumentsInUse);
 
         template <std::size_t N> void writeMessage(const std::array<std::uint8_t, N>& message);
 
@@ -79,17 +107,32 @@ namespace smf {
         babelwires::UserLogger& m_userLogger;
         const babelwires::ValueTreeRoot& m_smfFeature;
         std::ostream& m_ostream;
-        std::ostream* m_os;
+        /// Output is accumulated here before being written to the stream a chunk at a time.
+        /// Its capacity is reused from one chunk to the next.
+        std::vector<babelwires::Byte> m_buffer;
         /// Always use metrical time. Quater-note division.
         int m_division;
 
-        StandardPercussionSets m_standardPercussionSets;
+        /// If non-zero, this is used as the division and event times are quantized to it.
+        int m_targetDivision = 0;
+
+        bool m_useRunningStatus = false;
+
+        /// The status byte which the next channel message can omit, or 0 if it cannot omit its status byte.
+        babelwires::Byte m_runningStatus = 0;
+
+        /// The track chunks to write, as determined by analyzeTracks.
+        std::vector<TrackChunk> m_chunks;
+
+        const StandardPercussionSets& m_standardPercussionSets;
 
         /// Currently just used to determine which tracks are percussion tracks.
         struct ChannelSetup {
             // This is non-null when the pitches in the data should be interpreted as percussion events from the given
             // kit.
             const bw_music::PercussionSetWithPitchMap* m_kitIfPercussion = nullptr;
+            // The set-up which selects the kit, if any is required.
+            std::optional<StandardPercussionSets::ChannelSetupInfo> m_setupInfo;
             // Has channel set-up information been written for this channel yet?
             // (Since more than one track can correspond to a channel, we only want to write this for the first track
             // for each channel.)
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <Plugins/Smf/Plugin/Percussion/gs808909PercussionSet.hpp>
+#include <Plugins/Smf/Plugin/Percussion/gsSFXPercussionSet.hpp>
+#include <Plugins/Smf/Plugin/Percussion/standardPercussionSets.hpp>
 #include <Plugins/Smf/Plugin/gmSpec.hpp>
 #include <Plugins/Smf/Plugin/libRegistration.hpp>
 #include <Plugins/Smf/Plugin/midiTrackAndChannel.hpp>
@@ -238,8 +241,7 @@ TEST_P(SmfTrackAllocationPercussionTest, trackAllocation) {
     }
 }
 
-// Test how tracks get assigned in the various standards (the GS implementation in BabelWires-Music is not as flexible as the
-// full standard)
+// Test how tracks get assigned in the various standards.
 INSTANTIATE_TEST_SUITE_P(
     PercussionTest, SmfTrackAllocationPercussionTest,
     testing::Values(TrackAllocationTestData{smf::GMSpecType::Value::GM,
@@ -260,12 +262,12 @@ INSTANTIATE_TEST_SUITE_P(
                     TrackAllocationTestData{
                         smf::GMSpecType::Value::GS,
                         {{"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}},
-                        {true, false, false},
-                        {{}, {"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}}},
+                        {false, false, false},
+                        {{"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}}},
                     TrackAllocationTestData{smf::GMSpecType::Value::GS,
                                             {{"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}, {}},
-                                            {true, false, true},
-                                            {{}, {"AcBass", "HMTom", "OTrian"}, {}}},
+                                            {false, false, true},
+                                            {{"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}, {}}},
                     TrackAllocationTestData{
                         smf::GMSpecType::Value::XG,
                         {{"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}},
@@ -274,4 +276,61 @@ INSTANTIATE_TEST_SUITE_P(
                     TrackAllocationTestData{smf::GMSpecType::Value::XG,
                                             {{"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}, {}},
                                             {false, false, true},
-                                            {{"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}, {}}}));
\ No newline at end of file
+                                            {{"AcBass", "HMTom", "OTrian"}, {"AcBass", "HMTom", "OTrian"}, {}}}));
+
+TEST(SmfStandardPercussionSetsTest, sharedInstance) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    const smf::StandardPercussionSets& sets0 = smf::StandardPercussionSets::get(testEnvironment.m_projectContext);
+    const smf::StandardPercussionSets& sets1 = smf::StandardPercussionSets::get(testEnvironment.m_projectContext);
+    EXPECT_EQ(&sets0, &sets1);
+
+    std::array<std::unordered_set<babelwires::ShortId>, 16> instrumentsInUse;
+    instrumentsInUse[0] = {"AcBass", "HMTom", "OTrian"};
+    instrumentsInUse[9] = {"AcBass", "HMTom", "OTrian"};
+    const auto assignments = sets0.assignPercussionSets(smf::GMSpecType::Value::GM, instrumentsInUse);
+    EXPECT_EQ(assignments[9].m_percussionSet, sets0.getDefaultPercussionSet(smf::GMSpecType::Value::GM, 9));
+    EXPECT_EQ(assignments[9].m_numExcludedInstruments, 0);
+    EXPECT_EQ(assignments[0].m_percussionSet, nullptr);
+    EXPECT_EQ(assignments[0].m_numExcludedInstruments, 3);
+}
+
+// GS has two drum maps, so when three channels want different kits, the best two kits should be chosen.
+TEST(SmfStandardPercussionSetsTest, gsAssignment) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    const smf::StandardPercussionSets& sets = smf::StandardPercussionSets::get(testEnvironment.m_projectContext);
+
+    std::array<std::unordered_set<babelwires::ShortId>, 16> instrumentsInUse;
+    instrumentsInUse[0] = {"Bs909", "Bs808"};
+    instrumentsInUse[1] = {"Laugh", "Jetpln"};
+    instrumentsInUse[2] = {"Bs808"};
+    instrumentsInUse[9] = {"TimpF"};
+
+    const auto assignments = sets.assignPercussionSets(smf::GMSpecType::Value::GS, instrumentsInUse);
+
+    const auto& typeSystem = testEnvironment.m_projectContext.m_typeSystem;
+    const bw_music::PercussionSetWithPitchMap* const kit808909 = &typeSystem.getEntryByType<smf::Gs808909PercussionSet>();
+    const bw_music::PercussionSetWithPitchMap* const kitSFX = &typeSystem.getEntryByType<smf::GsSFXPercussionSet>();
+
+    EXPECT_EQ(assignments[0].m_percussionSet, kit808909);
+    EXPECT_EQ(assignments[1].m_percussionSet, kitSFX);
+    EXPECT_EQ(assignments[2].m_percussionSet, kit808909);
+    EXPECT_EQ(assignments[9].m_percussionSet, nullptr);
+    EXPECT_EQ(assignments[9].m_numExcludedInstruments, 1);
+
+    // Channels sharing a kit share a drum map.
+    ASSERT_TRUE(assignments[0].m_channelSetupInfo);
+    ASSERT_TRUE(assignments[1].m_channelSetupInfo);
+    ASSERT_TRUE(assignments[2].m_channelSetupInfo);
+    EXPECT_EQ(assignments[0].m_channelSetupInfo->m_gsPartMode, assignments[2].m_channelSetupInfo->m_gsPartMode);
+    EXPECT_NE(assignments[0].m_channelSetupInfo->m_gsPartMode, assignments[1].m_channelSetupInfo->m_gsPartMode);
+
+    for (int i = 3; i < 16; ++i) {
+        EXPECT_EQ(assignments[i].m_percussionSet, nullptr);
+    }
+}
@@ -14,6 +14,7 @@
 #include <BabelWiresLib/Types/File/fileTypeT.hpp>
 
 #include <Common/IO/fileDataSource.hpp>
+#include <Common/exceptions.hpp>
 
 #include <Tests/TestUtils/seqTestUtils.hpp>
 
@@ -21,6 +22,8 @@
 
 #include <Tests/TestUtils/tempFilePath.hpp>
 
+#include <sstream>
+
 TEST(SmfSaveLoadTest, cMajorScale) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
@@ -249,3 +252,357 @@ TEST(SmfSaveLoadTest, format1Chords) {
         }
     }
 }
+
+TEST(SmfSaveLoadTest, parseFromMemory) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    std::vector<babelwires::Byte> data;
+    {
+        babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.m_typeSystem,
+                                             babelwires::FileTypeT<smf::SmfSequence>::getThisType());
+        smfFeature.setToDefault();
+
+        smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->is<babelwires::ValueTreeNode>()};
+        smfType.selectTag("SMF1");
+        auto tracks = smfType.getTrcks1();
+        tracks.setSize(3);
+
+        for (int i = 0; i < 3; ++i) {
+            auto trackAndChan = tracks.getEntry(i);
+            trackAndChan.getChan().set(i);
+            bw_music::Track track;
+            testUtils::addSimpleNotes(chordPitches[i], track);
+            trackAndChan.getTrack().set(std::move(track));
+        }
+
+        std::ostringstream os;
+        smf::writeToSmf(testEnvironment.m_projectContext, testEnvironment.m_log, smfFeature, os);
+        const std::string bytes = os.str();
+        data.assign(bytes.begin(), bytes.end());
+    }
+
+    {
+        const auto feature = smf::parseSmfSequence(data, testEnvironment.m_projectContext, testEnvironment.m_log);
+        ASSERT_NE(feature, nullptr);
+
+        smf::SmfSequence::ConstInstance smfSequence{feature->getChild(0)->is<babelwires::ValueTreeNode>()};
+        auto tracks = smfSequence.getTrcks1();
+        EXPECT_EQ(tracks.getSize(), 3);
+
+        for (int i = 0; i < 3; ++i) {
+            auto track = tracks.getEntry(i);
+            EXPECT_EQ(track.getChan().get(), i);
+            testUtils::testSimpleNotes(chordPitches[i], track.getTrack().get());
+        }
+    }
+
+    // Cut the last track short, so its chunk extends past the end of the data.
+    data.resize(data.size() - 3);
+    EXPECT_THROW(smf::parseSmfSequence(data, testEnvironment.m_projectContext, testEnvironment.m_log),
+                 babelwires::ParseException);
+}
+
+TEST(SmfSaveLoadTest, format1ThreadCountDoesNotAffectResult) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    constexpr int numTracks = 12;
+    std::vector<babelwires::Byte> data;
+    {
+        babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.m_typeSystem,
+                                             babelwires::FileTypeT<smf::SmfSequence>::getThisType());
+        smfFeature.setToDefault();
+
+        smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->is<babelwires::ValueTreeNode>()};
+        smfType.selectTag("SMF1");
+        auto tracks = smfType.getTrcks1();
+        tracks.setSize(numTracks);
+
+        for (int i = 0; i < numTracks; ++i) {
+            auto trackAndChan = tracks.getEntry(i);
+            // Avoid channel 9, which can be interpreted as percussion.
+            trackAndChan.getChan().set((i < 9) ? i : i + 1);
+            bw_music::Track track;
+            testUtils::addSimpleNotes(chordPitches[i % 3], track);
+            trackAndChan.getTrack().set(std::move(track));
+        }
+
+        std::ostringstream os;
+        smf::writeToSmf(testEnvironment.m_projectContext, testEnvironment.m_log, smfFeature, os);
+        const std::string bytes = os.str();
+        data.assign(bytes.begin(), bytes.end());
+    }
+
+    std::vector<std::unique_ptr<babelwires::ValueTreeRoot>> results;
+    for (unsigned int maxThreads : {1, 4}) {
+        smf::SmfParser parser(data, testEnvironment.m_projectContext, testEnvironment.m_log);
+        parser.setMaxThreads(maxThreads);
+        parser.parse();
+        results.emplace_back(parser.getResult());
+    }
+
+    smf::SmfSequence::ConstInstance serialSequence{results[0]->getChild(0)->is<babelwires::ValueTreeNode>()};
+    smf::SmfSequence::ConstInstance parallelSequence{results[1]->getChild(0)->is<babelwires::ValueTreeNode>()};
+    ASSERT_EQ(serialSequence.getTrcks1().getSize(), numTracks);
+    ASSERT_EQ(parallelSequence.getTrcks1().getSize(), numTracks);
+    for (int i = 0; i < numTracks; ++i) {
+        EXPECT_EQ(parallelSequence.getTrcks1().getEntry(i).getChan().get(),
+                  serialSequence.getTrcks1().getEntry(i).getChan().get());
+        EXPECT_EQ(parallelSequence.getTrcks1().getEntry(i).getTrack().get(),
+                  serialSequence.getTrcks1().getEntry(i).getTrack().get());
+    }
+}
+
+TEST(SmfSaveLoadTest, longNote) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    // With a division of 1, this duration is 0x4000 ticks, whose variable-length encoding has an inner zero byte.
+    const bw_music::ModelDuration noteLength = 4096;
+
+    std::vector<babelwires::Byte> data;
+    {
+        babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.m_typeSystem,
+                                             babelwires::FileTypeT<smf::SmfSequence>::getThisType());
+        smfFeature.setToDefault();
+
+        smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->is<babelwires::ValueTreeNode>()};
+        auto track0 = smfType.getTrcks0().activateAndGetTrack(0);
+
+        bw_music::Track track;
+        track.addEvent(bw_music::NoteOnEvent{0, 60});
+        track.addEvent(bw_music::NoteOffEvent{noteLength, 60});
+        track0.set(std::move(track));
+
+        std::ostringstream os;
+        smf::writeToSmf(testEnvironment.m_projectContext, testEnvironment.m_log, smfFeature, os);
+        const std::string bytes = os.str();
+        data.assign(bytes.begin(), bytes.end());
+    }
+
+    const auto feature = smf::parseSmfSequence(data, testEnvironment.m_projectContext, testEnvironment.m_log);
+    ASSERT_NE(feature, nullptr);
+    smf::SmfSequence::ConstInstance smfSequence{feature->getChild(0)->is<babelwires::ValueTreeNode>()};
+    auto track0 = smfSequence.getTrcks0().tryGetTrack(0);
+    ASSERT_TRUE(track0);
+    testUtils::testNotes({{60, 0, noteLength}}, track0->get());
+}
+
+TEST(SmfSaveLoadTest, runningStatus) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    const std::vector<bw_music::Pitch> pitches{60, 62, 64, 65, 67, 69, 71, 72};
+    const std::vector<bw_music::Pitch> lowPitches{48, 50, 52, 53, 55, 57, 59, 60};
+
+    babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.m_typeSystem,
+                                         babelwires::FileTypeT<smf::SmfSequence>::getThisType());
+    smfFeature.setToDefault();
+    {
+        smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->is<babelwires::ValueTreeNode>()};
+        auto tracks = smfType.getTrcks0();
+
+        bw_music::Track track0;
+        testUtils::addSimpleNotes(pitches, track0);
+        tracks.activateAndGetTrack(0).set(std::move(track0));
+
+        // These note-offs do not have the default velocity, so they cannot be written as note-ons.
+        bw_music::Track track1;
+        for (auto pitch : lowPitches) {
+            track1.addEvent(bw_music::NoteOnEvent{0, pitch});
+            track1.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), pitch, 30});
+        }
+        tracks.activateAndGetTrack(1).set(std::move(track1));
+    }
+
+    std::vector<std::vector<babelwires::Byte>> data;
+    for (bool useRunningStatus : {false, true}) {
+        std::ostringstream os;
+        smf::SmfWriter writer(testEnvironment.m_projectContext, testEnvironment.m_log, smfFeature, os);
+        writer.setUseRunningStatus(useRunningStatus);
+        writer.write();
+        const std::string bytes = os.str();
+        data.emplace_back(bytes.begin(), bytes.end());
+    }
+    EXPECT_LT(data[1].size(), data[0].size());
+
+    const auto plainResult = smf::parseSmfSequence(data[0], testEnvironment.m_projectContext, testEnvironment.m_log);
+    const auto compactResult = smf::parseSmfSequence(data[1], testEnvironment.m_projectContext, testEnvironment.m_log);
+    ASSERT_NE(plainResult, nullptr);
+    ASSERT_NE(compactResult, nullptr);
+
+    smf::SmfSequence::ConstInstance plainSequence{plainResult->getChild(0)->is<babelwires::ValueTreeNode>()};
+    smf::SmfSequence::ConstInstance compactSequence{compactResult->getChild(0)->is<babelwires::ValueTreeNode>()};
+    for (unsigned int c : {0, 1}) {
+        auto plainTrack = plainSequence.getTrcks0().tryGetTrack(c);
+        auto compactTrack = compactSequence.getTrcks0().tryGetTrack(c);
+        ASSERT_TRUE(plainTrack);
+        ASSERT_TRUE(compactTrack);
+        EXPECT_EQ(compactTrack->get(), plainTrack->get());
+    }
+    testUtils::testSimpleNotes(pitches, compactSequence.getTrcks0().tryGetTrack(0)->get());
+
+    const bw_music::Track& lowTrack = compactSequence.getTrcks0().tryGetTrack(1)->get();
+    std::size_t numNoteOffs = 0;
+    for (const auto& event : lowTrack) {
+        if (const auto* noteOff = event.as<bw_music::NoteOffEvent>()) {
+            EXPECT_EQ(noteOff->getVelocity(), 30);
+            ++numNoteOffs;
+        }
+    }
+    EXPECT_EQ(numNoteOffs, lowPitches.size());
+}
+
+namespace {
+    /// Write the sequence with the given target division (0 for the default) and parse the result.
+    std::unique_ptr<babelwires::ValueTreeRoot> writeAndParse(testUtils::TestEnvironment& testEnvironment,
+                                                             const babelwires::ValueTreeRoot& smfFeature,
+                                                             int targetDivision) {
+        std::ostringstream os;
+        smf::SmfWriter writer(testEnvironment.m_projectContext, testEnvironment.m_log, smfFeature, os);
+        if (targetDivision != 0) {
+            writer.setTargetDivision(targetDivision);
+        }
+        writer.write();
+        const std::string bytes = os.str();
+        return smf::parseSmfSequence(std::vector<babelwires::Byte>(bytes.begin(), bytes.end()),
+                                     testEnvironment.m_projectContext, testEnvironment.m_log);
+    }
+} // namespace
+
+TEST(SmfSaveLoadTest, quantizationDoesNotDrift) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.m_typeSystem,
+                                         babelwires::FileTypeT<smf::SmfSequence>::getThisType());
+    smfFeature.setToDefault();
+    {
+        smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->is<babelwires::ValueTreeNode>()};
+        // Nine notes of a third of a whole note each. Rounding each one to a quarter note would lose three beats.
+        bw_music::Track track;
+        for (int i = 0; i < 9; ++i) {
+            track.addEvent(bw_music::NoteOnEvent{0, 60});
+            track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 3), 60});
+        }
+        smfType.getTrcks0().activateAndGetTrack(0).set(std::move(track));
+    }
+
+    const auto result = writeAndParse(testEnvironment, smfFeature, 1);
+    ASSERT_NE(result, nullptr);
+    smf::SmfSequence::ConstInstance sequence{result->getChild(0)->is<babelwires::ValueTreeNode>()};
+    auto parsedTrack = sequence.getTrcks0().tryGetTrack(0);
+    ASSERT_TRUE(parsedTrack);
+    EXPECT_EQ(parsedTrack->get().getDuration(), 3);
+
+    // Each note-off is at its exact time, rounded to the nearest quarter note.
+    babelwires::Rational time = 0;
+    int numNoteOffs = 0;
+    for (const auto& event : parsedTrack->get()) {
+        time += event.getTimeSinceLastEvent();
+        if (event.as<bw_music::NoteOffEvent>()) {
+            ++numNoteOffs;
+            const int expectedQuarterNotes = ((numNoteOffs * 8) + 3) / 6;
+            EXPECT_EQ(time, babelwires::Rational(expectedQuarterNotes, 4));
+        }
+    }
+    EXPECT_EQ(numNoteOffs, 9);
+}
+
+TEST(SmfSaveLoadTest, fallbackDivision) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.m_typeSystem,
+                                         babelwires::FileTypeT<smf::SmfSequence>::getThisType());
+    smfFeature.setToDefault();
+    {
+        smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->is<babelwires::ValueTreeNode>()};
+        auto tracks = smfType.getTrcks0();
+        // The lcm of these denominators cannot be represented in the division field.
+        for (int c : {0, 1}) {
+            const int denominator = (c == 0) ? 211 : 223;
+            bw_music::Track track;
+            for (int i = 0; i < denominator; ++i) {
+                track.addEvent(bw_music::NoteOnEvent{0, 60});
+                track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, denominator), 60});
+            }
+            tracks.activateAndGetTrack(c).set(std::move(track));
+        }
+    }
+
+    const auto result = writeAndParse(testEnvironment, smfFeature, 0);
+    ASSERT_NE(result, nullptr);
+    smf::SmfSequence::ConstInstance sequence{result->getChild(0)->is<babelwires::ValueTreeNode>()};
+    for (int c : {0, 1}) {
+        auto parsedTrack = sequence.getTrcks0().tryGetTrack(c);
+        ASSERT_TRUE(parsedTrack);
+        // The notes are quantized, but they still end exactly where they did.
+        EXPECT_EQ(parsedTrack->get().getDuration(), 1);
+        EXPECT_EQ(parsedTrack->get().getNumEvents(), 2 * ((c == 0) ? 211 : 223));
+    }
+}
+
+TEST(SmfSaveLoadTest, exactDivisionIsPerQuarterNote) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    // 1/65536 of a whole note needs a division of 16384, which fits, although 65536 does not.
+    bw_music::Track track;
+    track.addEvent(bw_music::NoteOnEvent{0, 60});
+    track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 65536), 60});
+    track.addEvent(bw_music::NoteOnEvent{0, 62});
+    track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(3, 65536), 62});
+    const bw_music::Track expectedTrack = track;
+
+    babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.m_typeSystem,
+                                         babelwires::FileTypeT<smf::SmfSequence>::getThisType());
+    smfFeature.setToDefault();
+    {
+        smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->is<babelwires::ValueTreeNode>()};
+        smfType.getTrcks0().activateAndGetTrack(0).set(std::move(track));
+    }
+
+    const auto result = writeAndParse(testEnvironment, smfFeature, 0);
+    ASSERT_NE(result, nullptr);
+    smf::SmfSequence::ConstInstance sequence{result->getChild(0)->is<babelwires::ValueTreeNode>()};
+    auto parsedTrack = sequence.getTrcks0().tryGetTrack(0);
+    ASSERT_TRUE(parsedTrack);
+    EXPECT_EQ(parsedTrack->get(), expectedTrack);
+}
+
+TEST(SmfSaveLoadTest, targetDivisionIsClamped) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    const std::vector<bw_music::Pitch> pitches{60, 62, 64, 65, 67, 69, 71, 72};
+
+    babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.m_typeSystem,
+                                         babelwires::FileTypeT<smf::SmfSequence>::getThisType());
+    smfFeature.setToDefault();
+    {
+        smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->is<babelwires::ValueTreeNode>()};
+        bw_music::Track track;
+        testUtils::addSimpleNotes(pitches, track);
+        smfType.getTrcks0().activateAndGetTrack(0).set(std::move(track));
+    }
+
+    // Quarter notes are exact at both ends of the range, so the notes survive if the division is clamped.
+    for (int targetDivision : {-5, 0x10000}) {
+        const auto result = writeAndParse(testEnvironment, smfFeature, targetDivision);
+        ASSERT_NE(result, nullptr);
+        smf::SmfSequence::ConstInstance sequence{result->getChild(0)->is<babelwires::ValueTreeNode>()};
+        auto parsedTrack = sequence.getTrcks0().tryGetTrack(0);
+        ASSERT_TRUE(parsedTrack);
+        testUtils::testSimpleNotes(pitches, parsedTrack->get());
+    }
+}
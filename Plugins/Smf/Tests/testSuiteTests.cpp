@@ -3,7 +3,9 @@
 #include <Plugins/Smf/Plugin/Percussion/gm2StandardPercussionSet.hpp>
 #include <Plugins/Smf/Plugin/libRegistration.hpp>
 #include <Plugins/Smf/Plugin/smfParser.hpp>
+#include <Plugins/Smf/Plugin/smfSequence.hpp>
 
+#include <MusicLib/Functions/transposeFunction.hpp>
 #include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
 #include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
 #include <MusicLib/Utilities/filteredTrackIterator.hpp>
@@ -168,6 +170,34 @@ TEST(SmfTestSuiteTest, multichannelChords2) {
     testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{67, 69, 71, 72, 74, 76, 77, 79}, track1.getTrack().get());
 }
 
+TEST(SmfTestSuiteTest, transformAllTracks) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    smf::registerLib(testEnvironment.m_projectContext);
+
+    // The first track chunk of this file carries two channels.
+    babelwires::FileDataSource midiFile("test-multichannel-chords-2.mid");
+
+    const auto feature = smf::parseSmfSequence(midiFile, testEnvironment.m_projectContext, testEnvironment.m_log);
+    ASSERT_NE(feature, nullptr);
+
+    smf::SmfSequence::Instance smfSequence{feature->getChild(0)->is<babelwires::ValueTreeNode>()};
+    const int numTracks = smf::transformAllTracks(
+        smfSequence, [](const bw_music::Track& track) { return bw_music::transposeTrack(track, 1); });
+    EXPECT_EQ(numTracks, 3);
+
+    auto tracks = smfSequence.getTrcks1();
+    ASSERT_EQ(tracks.getSize(), 2);
+    const auto& exCh1 = tracks.getEntry(0).tryGetTrack(1);
+    ASSERT_TRUE(exCh1);
+
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{61, 63, 65, 66, 68, 70, 72, 73},
+                               tracks.getEntry(0).getTrack().get());
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{65, 66, 68, 70, 72, 73, 75, 77}, exCh1->get());
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{68, 70, 72, 73, 75, 77, 78, 80},
+                               tracks.getEntry(1).getTrack().get());
+}
+
 TEST(SmfTestSuiteTest, multichannelChords3) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
@@ -0,0 +1,323 @@
+/**
+ * The smfbatch main function.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <SmfBatchExe/smfBatchOptions.hpp>
+#include <SmfBatchExe/workStealingPool.hpp>
+
+#include <Plugins/Smf/Plugin/libRegistration.hpp>
+#include <Plugins/Smf/Plugin/smfFormat.hpp>
+#include <Plugins/Smf/Plugin/smfSequence.hpp>
+
+#include <MusicLib/Functions/percussionMapFunction.hpp>
+#include <MusicLib/Functions/quantizeFunction.hpp>
+#include <MusicLib/Functions/transposeFunction.hpp>
+#include <MusicLib/Percussion/builtInPercussionInstruments.hpp>
+#include <MusicLib/libRegistration.hpp>
+
+#include <BabelWiresLib/FileFormat/sourceFileFormat.hpp>
+#include <BabelWiresLib/FileFormat/targetFileFormat.hpp>
+#include <BabelWiresLib/Processors/processorFactoryRegistry.hpp>
+#include <BabelWiresLib/Project/projectContext.hpp>
+#include <BabelWiresLib/TypeSystem/typeSystem.hpp>
+#include <BabelWiresLib/Types/File/fileTypeT.hpp>
+#include <BabelWiresLib/Types/Map/mapValue.hpp>
+#include <BabelWiresLib/Types/Map/standardMapIdentifiers.hpp>
+#include <BabelWiresLib/ValueTree/valueTreeRoot.hpp>
+#include <BabelWiresLib/libRegistration.hpp>
+
+#include <Common/Identifiers/identifierRegistry.hpp>
+#include <Common/Log/ostreamLogListener.hpp>
+#include <Common/Log/unifiedLog.hpp>
+#include <Common/Serialization/deserializationRegistry.hpp>
+#include <Common/exceptions.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+namespace {
+    /// The MusicLib functions applied to every track, configured from the options.
+    struct TrackPipeline {
+        const babelwires::TypeSystem& m_typeSystem;
+        int m_transpose = 0;
+        std::optional<babelwires::Rational> m_quantizeBeat;
+        std::optional<babelwires::MapValue> m_percussionMap;
+
+        bw_music::Track operator()(const bw_music::Track& trackIn) const {
+            bw_music::Track track = trackIn;
+            if (m_transpose != 0) {
+                track = bw_music::transposeTrack(track, m_transpose);
+            }
+            if (m_quantizeBeat) {
+                track = bw_music::quantize(track, *m_quantizeBeat);
+            }
+            if (m_percussionMap) {
+                track = bw_music::mapPercussionFunction(m_typeSystem, track, *m_percussionMap);
+            }
+            return track;
+        }
+    };
+
+    babelwires::ShortId getPercussionInstrument(const bw_music::BuiltInPercussionInstruments& builtInPercussion,
+                                                const std::string& name) {
+        const auto& instruments = builtInPercussion.getValueSet();
+        const auto it = std::find_if(instruments.begin(), instruments.end(),
+                                     [&name](babelwires::ShortId id) { return id.toString() == name; });
+        if (it == instruments.end()) {
+            throw babelwires::OptionError() << "\"" << name << "\" is not a built-in percussion instrument";
+        }
+        return *it;
+    }
+
+    babelwires::MapValue
+    makePercussionMap(const babelwires::TypeSystem& typeSystem,
+                      const std::vector<std::pair<std::string, std::string>>& percussionRemap) {
+        const bw_music::BuiltInPercussionInstruments& builtInPercussion =
+            typeSystem.getEntryByType<bw_music::BuiltInPercussionInstruments>();
+
+        std::vector<std::pair<babelwires::ShortId, babelwires::ShortId>> replacements;
+        replacements.reserve(percussionRemap.size());
+        for (const auto& [source, target] : percussionRemap) {
+            replacements.emplace_back(getPercussionInstrument(builtInPercussion, source),
+                                      target.empty() ? babelwires::getBlankValueId()
+                                                     : getPercussionInstrument(builtInPercussion, target));
+        }
+        return bw_music::getBuiltInPercussionMap(typeSystem, replacements);
+    }
+
+    bool isSmfFile(const std::filesystem::path& path) {
+        const std::string extension = path.extension().string();
+        return (extension == ".mid") || (extension == ".smf");
+    }
+
+    struct InputFile {
+        std::filesystem::path m_path;
+        /// Files found in a directory keep their path relative to that directory, so files with the same name in
+        /// different subdirectories do not collide.
+        std::filesystem::path m_relativeOutputPath;
+    };
+
+    std::vector<InputFile> getInputFiles(const std::vector<std::filesystem::path>& inputPaths) {
+        std::vector<InputFile> files;
+        for (const auto& path : inputPaths) {
+            if (std::filesystem::is_directory(path)) {
+                for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+                    if (entry.is_regular_file() && isSmfFile(entry.path())) {
+                        files.emplace_back(InputFile{entry.path(), entry.path().lexically_relative(path)});
+                    }
+                }
+            } else {
+                files.emplace_back(InputFile{path, path.filename()});
+            }
+        }
+        return files;
+    }
+
+    /// Two input files can still map to the same output path when they come from different inputs. Since they
+    /// would be written concurrently and one would be lost, this is an error.
+    void checkForDuplicateOutputs(const std::vector<InputFile>& inputFiles) {
+        std::map<std::filesystem::path, const std::filesystem::path*> outputToInput;
+        for (const auto& inputFile : inputFiles) {
+            const auto [it, wasInserted] =
+                outputToInput.emplace(inputFile.m_relativeOutputPath.lexically_normal(), &inputFile.m_path);
+            if (!wasInserted) {
+                throw babelwires::OptionError() << "Both " << it->second->string() << " and "
+                                                << inputFile.m_path.string() << " would be written to "
+                                                << it->first.string();
+            }
+        }
+    }
+
+    void createOutputDirectories(const std::filesystem::path& outputDirectory,
+                                 const std::vector<InputFile>& inputFiles) {
+        std::set<std::filesystem::path> directories{outputDirectory};
+        for (const auto& inputFile : inputFiles) {
+            directories.emplace((outputDirectory / inputFile.m_relativeOutputPath).parent_path());
+        }
+        for (const auto& directory : directories) {
+            std::error_code errorCode;
+            std::filesystem::create_directories(directory, errorCode);
+            if (errorCode) {
+                throw babelwires::IoException()
+                    << "Cannot create output directory " << directory.string() << ": " << errorCode.message();
+            }
+        }
+    }
+
+    struct FileResult {
+        bool m_succeeded = false;
+        std::uintmax_t m_numBytes = 0;
+        int m_numTracks = 0;
+        double m_milliseconds = 0;
+        bool m_hasLogMessages = false;
+    };
+
+    struct Formats {
+        smf::SmfSourceFormat m_sourceFormat;
+        smf::SmfTargetFormat m_targetFormat;
+    };
+
+    FileResult convertFile(const babelwires::ProjectContext& projectContext, const Formats& formats,
+                           const TrackPipeline& pipeline, const std::filesystem::path& inputPath,
+                           const std::filesystem::path& outputPath, std::mutex& outputMutex) {
+        // Logs are kept per file, since files are processed concurrently. They are printed with the file's result.
+        babelwires::UnifiedLog log;
+        std::ostringstream logMessages;
+        babelwires::OStreamLogListener logListener(logMessages, log, babelwires::OStreamLogListener::Features::none);
+
+        FileResult result;
+        std::string errorMessage;
+        const auto startTime = std::chrono::steady_clock::now();
+        try {
+            result.m_numBytes = std::filesystem::file_size(inputPath);
+            std::unique_ptr<babelwires::ValueTreeRoot> contents =
+                formats.m_sourceFormat.loadFromFile(inputPath, projectContext, log);
+            babelwires::FileTypeT<smf::SmfSequence>::Instance smfFile{*contents};
+            result.m_numTracks = smf::transformAllTracks(smfFile.getConts(), std::cref(pipeline));
+            formats.m_targetFormat.writeToFile(projectContext, log, *contents, outputPath);
+            result.m_succeeded = true;
+        } catch (const babelwires::BaseException& e) {
+            errorMessage = e.what();
+        } catch (const std::exception& e) {
+            errorMessage = e.what();
+        }
+        const auto endTime = std::chrono::steady_clock::now();
+        result.m_milliseconds = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+        const std::string messages = logMessages.str();
+        result.m_hasLogMessages = !messages.empty();
+
+        std::lock_guard lock(outputMutex);
+        std::ostream& os = result.m_succeeded ? std::cout : std::cerr;
+        if (result.m_succeeded) {
+            os << inputPath.string() << ": " << result.m_numTracks << " tracks, " << result.m_numBytes << " bytes, "
+               << std::fixed << std::setprecision(2) << result.m_milliseconds << " ms" << std::endl;
+        } else {
+            os << inputPath.string() << ": failed after " << std::fixed << std::setprecision(2)
+               << result.m_milliseconds << " ms: " << errorMessage << std::endl;
+        }
+        std::istringstream messageLines(messages);
+        for (std::string line; std::getline(messageLines, line);) {
+            os << "  " << line << std::endl;
+        }
+        return result;
+    }
+
+    void convertMode(const babelwires::ProjectContext& projectContext,
+                     const ProgramOptions::ConvertOptions& convertOptions) {
+        TrackPipeline pipeline{projectContext.m_typeSystem, convertOptions.m_transpose, convertOptions.m_quantizeBeat};
+        if (!convertOptions.m_percussionRemap.empty()) {
+            pipeline.m_percussionMap = makePercussionMap(projectContext.m_typeSystem, convertOptions.m_percussionRemap);
+        }
+
+        const std::vector<InputFile> inputFiles = getInputFiles(convertOptions.m_inputPaths);
+        if (inputFiles.empty()) {
+            throw babelwires::OptionError() << "No Standard MIDI Files were found in the inputs";
+        }
+        checkForDuplicateOutputs(inputFiles);
+        createOutputDirectories(convertOptions.m_outputDirectory, inputFiles);
+
+        Formats formats;
+        // Files are already converted in parallel, so each file is parsed on a single thread.
+        formats.m_sourceFormat.setMaxParserThreads(1);
+        std::vector<FileResult> results(inputFiles.size());
+        std::mutex outputMutex;
+        smf_batch::WorkStealingPool pool(convertOptions.m_numThreads);
+
+        const auto startTime = std::chrono::steady_clock::now();
+        pool.run(inputFiles.size(), [&](std::size_t i) {
+            const std::filesystem::path outputPath =
+                convertOptions.m_outputDirectory / inputFiles[i].m_relativeOutputPath;
+            results[i] = convertFile(projectContext, formats, pipeline, inputFiles[i].m_path, outputPath, outputMutex);
+        });
+        const auto endTime = std::chrono::steady_clock::now();
+        const double wallSeconds = std::chrono::duration<double>(endTime - startTime).count();
+
+        std::size_t numSucceeded = 0;
+        std::size_t numWithLogMessages = 0;
+        std::uintmax_t totalBytes = 0;
+        double totalFileMilliseconds = 0;
+        for (const auto& result : results) {
+            if (result.m_succeeded) {
+                ++numSucceeded;
+                totalBytes += result.m_numBytes;
+            }
+            if (result.m_hasLogMessages) {
+                ++numWithLogMessages;
+            }
+            totalFileMilliseconds += result.m_milliseconds;
+        }
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Converted " << numSucceeded << " of " << inputFiles.size() << " files in " << wallSeconds
+                  << " s using " << pool.getNumThreads() << " threads." << std::endl;
+        if (wallSeconds > 0) {
+            std::cout << "Throughput: " << (numSucceeded / wallSeconds) << " files/s, "
+                      << (totalBytes / wallSeconds / (1024 * 1024)) << " MiB/s." << std::endl;
+        }
+        std::cout << "Mean time per file: " << (totalFileMilliseconds / inputFiles.size()) << " ms." << std::endl;
+        if (numWithLogMessages > 0) {
+            std::cout << numWithLogMessages << " files logged warnings or errors." << std::endl;
+        }
+        if (numSucceeded < inputFiles.size()) {
+            throw babelwires::IoException() << (inputFiles.size() - numSucceeded) << " files could not be converted";
+        }
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    babelwires::UnifiedLog log;
+    babelwires::DebugLogger::swapGlobalDebugLogger(&log);
+    babelwires::IdentifierRegistryScope identifierRegistry;
+
+    babelwires::DeserializationRegistry deserializationRegistry;
+    babelwires::SourceFileFormatRegistry sourceFileFormatRegistry;
+    babelwires::TargetFileFormatRegistry targetFileFormatRegistry;
+    babelwires::ProcessorFactoryRegistry processorRegistry;
+    babelwires::TypeSystem typeSystem;
+
+    babelwires::ProjectContext projectContext{deserializationRegistry, sourceFileFormatRegistry,
+                                              targetFileFormatRegistry, processorRegistry, typeSystem};
+
+    babelwires::registerLib(projectContext);
+    bw_music::registerLib(projectContext);
+    smf::registerLib(projectContext);
+
+    try {
+        ProgramOptions options(argc, argv);
+
+        switch (options.m_mode) {
+            case ProgramOptions::MODE_PRINT_HELP: {
+                writeHelp(argv[0], std::cout);
+                break;
+            }
+            case ProgramOptions::MODE_CONVERT: {
+                convertMode(projectContext, *options.m_convertOptions);
+                break;
+            }
+        }
+    } catch (const babelwires::OptionError& e) {
+        std::cerr << e.what() << std::endl;
+        writeUsage(argv[0], std::cerr);
+        return EXIT_FAILURE;
+    } catch (const babelwires::BaseException& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        // For example, a std::filesystem_error from scanning an input directory.
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+/**
+ * Options for the smfbatch program.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <SmfBatchExe/smfBatchOptions.hpp>
+
+#include <Common/exceptions.hpp>
+
+namespace {
+    const char s_helpString[] = "help";
+
+    int parseInt(const std::string& arg, const char* optionName) {
+        std::size_t end = 0;
+        int value = 0;
+        try {
+            value = std::stoi(arg, &end);
+        } catch (const std::exception&) {
+            end = 0;
+        }
+        if ((end == 0) || (end != arg.size())) {
+            throw babelwires::OptionError() << "Option " << optionName << " expects an integer but got \"" << arg
+                                            << "\"";
+        }
+        return value;
+    }
+
+    babelwires::Rational parseBeat(const std::string& arg) {
+        const std::size_t slash = arg.find('/');
+        const int numerator = parseInt(arg.substr(0, slash), "-q");
+        const int denominator = (slash == std::string::npos) ? 1 : parseInt(arg.substr(slash + 1), "-q");
+        if ((numerator <= 0) || (denominator <= 0)) {
+            throw babelwires::OptionError() << "Option -q expects a positive beat such as 1/16";
+        }
+        return babelwires::Rational(numerator, denominator);
+    }
+} // namespace
+
+ProgramOptions::ProgramOptions(int argc, char* argv[])
+    : m_mode(MODE_PRINT_HELP) {
+    if (argc < 2) {
+        throw babelwires::OptionError() << "No arguments specified";
+    }
+
+    const std::string firstArg = argv[1];
+    if ((firstArg == s_helpString) || (firstArg == "-h") || (firstArg == "--help")) {
+        m_mode = MODE_PRINT_HELP;
+        return;
+    }
+
+    m_mode = MODE_CONVERT;
+    m_convertOptions.emplace();
+    int i = 1;
+    while ((i < argc) && (argv[i][0] == '-')) {
+        const std::string nextArg = argv[i];
+        if (i == argc - 1) {
+            throw babelwires::OptionError() << "Option " << nextArg << " expects an argument";
+        }
+        const std::string value = argv[i + 1];
+        if (nextArg == "-o") {
+            m_convertOptions->m_outputDirectory = value;
+        } else if (nextArg == "-j") {
+            const int numThreads = parseInt(value, "-j");
+            if (numThreads < 0) {
+                throw babelwires::OptionError() << "Option -j expects a non-negative number of threads";
+            }
+            m_convertOptions->m_numThreads = numThreads;
+        } else if (nextArg == "-t") {
+            m_convertOptions->m_transpose = parseInt(value, "-t");
+        } else if (nextArg == "-q") {
+            m_convertOptions->m_quantizeBeat = parseBeat(value);
+        } else if (nextArg == "-p") {
+            const std::size_t equals = value.find('=');
+            if ((equals == 0) || (equals == std::string::npos)) {
+                throw babelwires::OptionError() << "Option -p expects an argument of the form <source>=<target>";
+            }
+            m_convertOptions->m_percussionRemap.emplace_back(value.substr(0, equals), value.substr(equals + 1));
+        } else {
+            throw babelwires::OptionError() << "Unrecognized option \"" << nextArg << "\"";
+        }
+        i += 2;
+    }
+    if (m_convertOptions->m_outputDirectory.empty()) {
+        throw babelwires::OptionError() << "An output directory must be provided with -o";
+    }
+    if (i == argc) {
+        throw babelwires::OptionError() << "No input files provided";
+    }
+    for (; i < argc; ++i) {
+        m_convertOptions->m_inputPaths.emplace_back(argv[i]);
+    }
+}
+
+void writeUsage(const std::string& programName, std::ostream& stream) {
+    stream << "Usage:" << std::endl;
+    stream << programName
+           << " [-j <threads>] [-t <semitones>] [-q <beat>] [-p <source>=<target>]... -o <output directory> <input "
+              "files or directories>..."
+           << std::endl;
+    stream << programName << " " << s_helpString << " " << std::endl;
+}
+
+void writeHelp(const std::string& programName, std::ostream& stream) {
+    stream << programName
+           << " - Loads Standard MIDI Files, transposes, quantizes and remaps percussion in all their tracks, and "
+              "writes the results to the output directory. Files found in an input directory keep their path "
+              "relative to it. Files are processed concurrently."
+           << std::endl;
+    writeUsage(programName, stream);
+    stream << "  -j  The number of threads. The default uses the available hardware threads." << std::endl;
+    stream << "  -t  Transpose notes and chords by the given number of semitones." << std::endl;
+    stream << "  -q  Quantize events to the given beat, e.g. 1/16." << std::endl;
+    stream << "  -p  Replace one built-in percussion instrument by another, e.g. Clap=Cowbll. An empty target "
+              "removes the instrument. May be repeated."
+           << std::endl;
+}
@@ -0,0 +1,45 @@
+/**
+ * Options for the smfbatch program.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <Common/Math/rational.hpp>
+
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ProgramOptions {
+    ProgramOptions(int argc, char* argv[]);
+
+    enum Mode { MODE_PRINT_HELP, MODE_CONVERT };
+
+    struct ConvertOptions {
+        /// Files and directories. Directories are searched recursively for Standard MIDI Files.
+        std::vector<std::filesystem::path> m_inputPaths;
+        /// Converted files are written here, keeping their file names.
+        std::filesystem::path m_outputDirectory;
+        /// Zero means use the available hardware threads.
+        unsigned int m_numThreads = 0;
+        /// The pitch offset applied to note and chord events.
+        int m_transpose = 0;
+        /// When set, events are quantized to this beat.
+        std::optional<babelwires::Rational> m_quantizeBeat;
+        /// Pairs of built-in percussion instrument identifiers. An empty target removes the instrument.
+        std::vector<std::pair<std::string, std::string>> m_percussionRemap;
+    };
+
+    Mode m_mode;
+
+    std::optional<ConvertOptions> m_convertOptions;
+};
+
+void writeUsage(const std::string& programName, std::ostream& stream);
+void writeHelp(const std::string& programName, std::ostream& stream);
@@ -0,0 +1,77 @@
+/**
+ * A simple thread pool which balances a batch of tasks by work-stealing.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <SmfBatchExe/workStealingPool.hpp>
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+
+smf_batch::WorkStealingPool::WorkStealingPool(unsigned int numThreads)
+    : m_numThreads(numThreads ? numThreads : std::max(std::thread::hardware_concurrency(), 1u))
+    , m_queues(m_numThreads) {}
+
+unsigned int smf_batch::WorkStealingPool::getNumThreads() const {
+    return m_numThreads;
+}
+
+void smf_batch::WorkStealingPool::run(std::size_t numTasks, const std::function<void(std::size_t)>& task) {
+    // Tasks are only added here, before any thread starts, so a worker which finds every queue empty is finished.
+    for (unsigned int w = 0; w < m_numThreads; ++w) {
+        const std::size_t begin = (numTasks * w) / m_numThreads;
+        const std::size_t end = (numTasks * (w + 1)) / m_numThreads;
+        // Pushed in reverse, so the owner works forwards through its block while thieves take from its end.
+        for (std::size_t i = end; i > begin; --i) {
+            m_queues[w].m_tasks.push_back(i - 1);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(m_numThreads - 1);
+    try {
+        for (unsigned int w = 1; w < m_numThreads; ++w) {
+            threads.emplace_back([this, w, &task]() { workerLoop(w, task); });
+        }
+    } catch (const std::system_error&) {
+        // A thread could not be started. Its queue is emptied by stealing, so the tasks still all run.
+    }
+    workerLoop(0, task);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void smf_batch::WorkStealingPool::workerLoop(unsigned int workerIndex, const std::function<void(std::size_t)>& task) {
+    std::size_t taskIndex;
+    while (tryPopOwnTask(workerIndex, taskIndex) || tryStealTask(workerIndex, taskIndex)) {
+        task(taskIndex);
+    }
+}
+
+bool smf_batch::WorkStealingPool::tryPopOwnTask(unsigned int workerIndex, std::size_t& taskOut) {
+    WorkerQueue& queue = m_queues[workerIndex];
+    std::lock_guard lock(queue.m_mutex);
+    if (queue.m_tasks.empty()) {
+        return false;
+    }
+    taskOut = queue.m_tasks.back();
+    queue.m_tasks.pop_back();
+    return true;
+}
+
+bool smf_batch::WorkStealingPool::tryStealTask(unsigned int workerIndex, std::size_t& taskOut) {
+    for (unsigned int i = 1; i < m_numThreads; ++i) {
+        WorkerQueue& victim = m_queues[(workerIndex + i) % m_numThreads];
+        std::lock_guard lock(victim.m_mutex);
+        if (!victim.m_tasks.empty()) {
+            taskOut = victim.m_tasks.front();
+            victim.m_tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,50 @@
+/**
+ * A simple thread pool which balances a batch of tasks by work-stealing.
+ *
+ * (C) 2021 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace smf_batch {
+    /// Runs a batch of independent tasks on a fixed number of threads.
+    /// Each thread starts with a contiguous block of the tasks in its own queue. A thread which runs out of work
+    /// steals from the opposite end of another thread's queue, so a few slow tasks do not leave threads idle.
+    class WorkStealingPool {
+      public:
+        /// A numThreads of zero means use the available hardware threads.
+        WorkStealingPool(unsigned int numThreads);
+
+        unsigned int getNumThreads() const;
+
+        /// Call task(i) for each i in [0, numTasks) and return when all calls have finished.
+        /// The task is called concurrently and must not throw. If a thread cannot be started, fewer threads are used.
+        void run(std::size_t numTasks, const std::function<void(std::size_t)>& task);
+
+      private:
+        struct WorkerQueue {
+            std::mutex m_mutex;
+            std::deque<std::size_t> m_tasks;
+        };
+
+        /// The body of each thread.
+        void workerLoop(unsigned int workerIndex, const std::function<void(std::size_t)>& task);
+
+        /// Take a task from the back of the worker's own queue.
+        bool tryPopOwnTask(unsigned int workerIndex, std::size_t& taskOut);
+
+        /// Take a task from the front of another worker's queue.
+        bool tryStealTask(unsigned int workerIndex, std::size_t& taskOut);
+
+      private:
+        unsigned int m_numThreads;
+        std::vector<WorkerQueue> m_queues;
+    };
+} // namespace smf_batch
@@ -326,6 +326,32 @@ TEST(ChordMapProcessorTest, chordsAndNotes) {
     EXPECT_EQ(preCombinedOutput, postCombinedOutput);
 }
 
+TEST(ChordMapProcessorTest, compiledChordMap) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+
+    babelwires::MapValue chordMap = getTestChordMap(testEnvironment.m_typeSystem, SourceMode::SilenceToChord,
+                                                    TargetMode::ChordToSilence, WildcardMode::Wildcards);
+    const bw_music::CompiledChordMap compiledChordMap(testEnvironment.m_typeSystem, chordMap);
+
+    using PitchClass = bw_music::PitchClass::Value;
+    using ChordType = bw_music::ChordType::Value;
+
+    EXPECT_EQ(compiledChordMap.getNoChordTarget(), (bw_music::Chord{PitchClass::Fsh, ChordType::m7_11}));
+    EXPECT_EQ(compiledChordMap[{PitchClass::D, ChordType::m}], (bw_music::Chord{PitchClass::A, ChordType::m7}));
+    // The wildcard pitch class is carried to the target.
+    EXPECT_EQ(compiledChordMap[{PitchClass::E, ChordType::M7s11}], (bw_music::Chord{PitchClass::E, ChordType::m7}));
+    EXPECT_EQ(compiledChordMap[{PitchClass::B, ChordType::M7s11}], (bw_music::Chord{PitchClass::B, ChordType::m7}));
+    EXPECT_FALSE(compiledChordMap[{PitchClass::Gsh, ChordType::M6}]);
+    // The wildcard chord type maps every Dsh chord to silence.
+    EXPECT_FALSE(compiledChordMap[{PitchClass::Dsh, ChordType::M}]);
+    EXPECT_FALSE(compiledChordMap[{PitchClass::Dsh, ChordType::mM7b5}]);
+    // The fallback leaves other chords alone, including the first and last entries of the table.
+    EXPECT_EQ(compiledChordMap[{PitchClass::C, ChordType::M}], (bw_music::Chord{PitchClass::C, ChordType::M}));
+    EXPECT_EQ(compiledChordMap[{PitchClass::B, ChordType::mM7b5}],
+              (bw_music::Chord{PitchClass::B, ChordType::mM7b5}));
+}
+
 TEST(ChordMapProcessorTest, processor) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
@@ -121,6 +121,23 @@ TEST(ExcerptProcessorTest, funcGaps) {
     testUtils::testNotes(expectedNoteInfos, trackOut);
 }
 
+TEST(ExcerptProcessorTest, funcLongTrack) {
+    std::vector<bw_music::Pitch> pitches;
+    for (int i = 0; i < 3000; ++i) {
+        pitches.emplace_back(40 + (i % 40));
+    }
+    bw_music::Track trackIn;
+    testUtils::addSimpleNotes(pitches, trackIn);
+
+    // Take excerpts from several segments.
+    for (int startNote = 0; startNote < 3000; startNote += 700) {
+        auto trackOut = bw_music::getTrackExcerpt(trackIn, babelwires::Rational(startNote, 4), 2);
+
+        testUtils::testSimpleNotes(
+            std::vector<bw_music::Pitch>(pitches.begin() + startNote, pitches.begin() + startNote + 8), trackOut);
+    }
+}
+
 TEST(ExcerptProcessorTest, processor) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
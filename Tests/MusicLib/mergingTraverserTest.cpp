@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Utilities/mergingTraverser.hpp>
+
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+namespace {
+    struct VisitedEvent {
+        int m_trackIndex;
+        bw_music::ModelDuration m_time;
+        bw_music::Pitch m_pitch;
+    };
+} // namespace
+
+TEST(MergingTraverser, empty) {
+    bw_music::MergingTraverser traverser({});
+    EXPECT_EQ(traverser.getDuration(), 0);
+    int numEventsVisited = 0;
+    traverser.visitEvents([&numEventsVisited](int, bw_music::Ticks, const bw_music::Track::const_iterator&) {
+        ++numEventsVisited;
+    });
+    EXPECT_EQ(numEventsVisited, 0);
+}
+
+TEST(MergingTraverser, orderAndTies) {
+    // Notes of length 1/4.
+    bw_music::Track trackA;
+    testUtils::addSimpleNotes({72, 74}, trackA);
+
+    // Notes of length 1/3.
+    bw_music::Track trackB;
+    trackB.addEvent(bw_music::NoteOnEvent{0, 60});
+    trackB.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 3), 60});
+    trackB.addEvent(bw_music::NoteOnEvent{babelwires::Rational(1, 6), 62});
+    trackB.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 3), 62});
+
+    bw_music::Track emptyTrack(babelwires::Rational(1, 2));
+
+    // Another track whose events coincide with trackA's.
+    bw_music::Track trackC;
+    testUtils::addSimpleNotes({48, 50}, trackC);
+
+    bw_music::MergingTraverser traverser({&trackA, &trackB, &emptyTrack, &trackC});
+    EXPECT_EQ(traverser.getTimebase(), bw_music::Timebase(12));
+    EXPECT_EQ(traverser.getDuration(), babelwires::Rational(5, 6));
+
+    std::vector<VisitedEvent> visitedEvents;
+    traverser.visitEvents([&visitedEvents, &traverser](int trackIndex, bw_music::Ticks time,
+                                                       const bw_music::Track::const_iterator& it) {
+        visitedEvents.emplace_back(VisitedEvent{trackIndex, traverser.getTimebase().toModelDuration(time),
+                                                it->as<bw_music::NoteEvent>()->m_pitch});
+    });
+
+    const std::vector<VisitedEvent> expectedEvents = {
+        {0, 0, 72},
+        {1, 0, 60},
+        {3, 0, 48},
+        {0, babelwires::Rational(1, 4), 72},
+        {0, babelwires::Rational(1, 4), 74},
+        {3, babelwires::Rational(1, 4), 48},
+        {3, babelwires::Rational(1, 4), 50},
+        {1, babelwires::Rational(1, 3), 60},
+        {0, babelwires::Rational(1, 2), 74},
+        {1, babelwires::Rational(1, 2), 62},
+        {3, babelwires::Rational(1, 2), 50},
+        {1, babelwires::Rational(5, 6), 62},
+    };
+    ASSERT_EQ(visitedEvents.size(), expectedEvents.size());
+    for (int i = 0; i < expectedEvents.size(); ++i) {
+        EXPECT_EQ(visitedEvents[i].m_trackIndex, expectedEvents[i].m_trackIndex);
+        EXPECT_EQ(visitedEvents[i].m_time, expectedEvents[i].m_time);
+        EXPECT_EQ(visitedEvents[i].m_pitch, expectedEvents[i].m_pitch);
+    }
+}
@@ -115,6 +115,26 @@ TEST(PercussionMapProcessorTest, funcSimple) {
     EXPECT_EQ(outputTrack, expectedOutputTrack);
 }
 
+TEST(PercussionMapProcessorTest, funcBuiltInPercussionMap) {
+    babelwires::TypeSystem typeSystem;
+    const bw_music::BuiltInPercussionInstruments* const builtInPercussion =
+        typeSystem.addEntry<bw_music::BuiltInPercussionInstruments>();
+    typeSystem.addTypeConstructor<babelwires::EnumAtomTypeConstructor>();
+    typeSystem.addTypeConstructor<babelwires::EnumUnionTypeConstructor>();
+
+    using Instrument = bw_music::BuiltInPercussionInstruments::Value;
+    const babelwires::MapValue mapValue = bw_music::getBuiltInPercussionMap(
+        typeSystem, {{builtInPercussion->getIdentifierFromValue(Instrument::Clap),
+                      builtInPercussion->getIdentifierFromValue(Instrument::Cowbll)},
+                     {builtInPercussion->getIdentifierFromValue(Instrument::Crash1),
+                      builtInPercussion->getIdentifierFromValue(Instrument::Crash2)},
+                     {builtInPercussion->getIdentifierFromValue(Instrument::LFlTom), babelwires::getBlankValueId()}});
+    EXPECT_TRUE(mapValue.isValid(typeSystem));
+
+    const bw_music::Track outputTrack = bw_music::mapPercussionFunction(typeSystem, getTestInputTrack(), mapValue);
+    EXPECT_EQ(outputTrack, getTestOutputTrack());
+}
+
 TEST(PercussionMapProcessorTest, processor) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
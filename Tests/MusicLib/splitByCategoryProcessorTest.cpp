@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <BabelWiresLib/ValueTree/valueTreeRoot.hpp>
+
+#include <MusicLib/Functions/splitByCategoryFunction.hpp>
+#include <MusicLib/Processors/splitByCategoryProcessor.hpp>
+#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/libRegistration.hpp>
+
+#include <Tests/BabelWiresLib/TestUtils/testEnvironment.hpp>
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+namespace {
+    void addNotesAndChords(bw_music::Track& track) {
+        track.addEvent(bw_music::NoteOnEvent{0, 72});
+        track.addEvent(bw_music::ChordOnEvent{
+            0, {bw_music::PitchClass::PitchClass::Value::C, bw_music::ChordType::ChordType::Value::M}});
+        track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 72});
+        track.addEvent(bw_music::NoteOnEvent{0, 74});
+        track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 74});
+        track.addEvent(bw_music::ChordOffEvent{0});
+        track.addEvent(bw_music::ChordOnEvent{
+            babelwires::Rational(1, 4),
+            {bw_music::PitchClass::PitchClass::Value::D, bw_music::ChordType::ChordType::Value::m}});
+        track.addEvent(bw_music::NoteOnEvent{0, 76});
+        track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 76});
+        track.addEvent(bw_music::ChordOffEvent{0});
+        ASSERT_EQ(track.getDuration(), 1);
+    }
+} // namespace
+
+TEST(SplitByCategoryProcessorTest, simpleFunction) {
+    bw_music::Track track;
+    addNotesAndChords(track);
+
+    std::vector<bw_music::Track> result =
+        bw_music::splitByCategory(track, {bw_music::ChordEvent::s_chordEventCategory});
+    ASSERT_EQ(result.size(), 2);
+
+    testUtils::testChords({{{bw_music::PitchClass::PitchClass::Value::C, bw_music::ChordType::ChordType::Value::M}},
+                           {{bw_music::PitchClass::PitchClass::Value::D, bw_music::ChordType::ChordType::Value::m},
+                            babelwires::Rational(1, 4),
+                            babelwires::Rational(1, 4)}},
+                          result[0]);
+    EXPECT_EQ(result[0].getDuration(), 1);
+    testUtils::testNotes({{72}, {74}, {76, babelwires::Rational(1, 4)}}, result[1]);
+    EXPECT_EQ(result[1].getDuration(), 1);
+}
+
+TEST(SplitByCategoryProcessorTest, processor) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+
+    bw_music::SplitByCategoryProcessor processor(testEnvironment.m_projectContext);
+
+    processor.getInput().setToDefault();
+    processor.getOutput().setToDefault();
+
+    auto input = bw_music::SplitByCategoryProcessorInput::Instance(processor.getInput());
+    const auto output = bw_music::SplitByCategoryProcessorOutput::ConstInstance(processor.getOutput());
+
+    {
+        bw_music::Track track;
+        addNotesAndChords(track);
+        input.getInput().set(std::move(track));
+    }
+    processor.process(testEnvironment.m_log);
+
+    testUtils::testNotes({{72}, {74}, {76, babelwires::Rational(1, 4)}}, output.getNotes().get());
+    EXPECT_EQ(output.getNotes().get().getDuration(), 1);
+    testUtils::testChords({{{bw_music::PitchClass::PitchClass::Value::C, bw_music::ChordType::ChordType::Value::M}},
+                           {{bw_music::PitchClass::PitchClass::Value::D, bw_music::ChordType::ChordType::Value::m},
+                            babelwires::Rational(1, 4),
+                            babelwires::Rational(1, 4)}},
+                          output.getChords().get());
+    EXPECT_EQ(output.getChords().get().getDuration(), 1);
+    EXPECT_EQ(output.getPercussion().get().getNumEvents(), 0);
+    EXPECT_EQ(output.getPercussion().get().getDuration(), 1);
+    EXPECT_EQ(output.getOther().get().getNumEvents(), 0);
+    EXPECT_EQ(output.getOther().get().getDuration(), 1);
+}
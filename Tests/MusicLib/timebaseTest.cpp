@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/timebase.hpp>
+#include <MusicLib/Types/Track/track.hpp>
+#include <MusicLib/Utilities/musicUtilities.hpp>
+
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+TEST(Timebase, ticks) {
+    bw_music::Timebase timebase(12);
+    EXPECT_EQ(timebase.getTicksPerWholeNote(), 12);
+    EXPECT_TRUE(timebase.canRepresent(babelwires::Rational(1, 4)));
+    EXPECT_TRUE(timebase.canRepresent(babelwires::Rational(5, 6)));
+    EXPECT_FALSE(timebase.canRepresent(babelwires::Rational(1, 8)));
+
+    EXPECT_EQ(timebase.toTicks(0), 0);
+    EXPECT_EQ(timebase.toTicks(2), 24);
+    EXPECT_EQ(timebase.toTicks(babelwires::Rational(1, 4)), 3);
+    EXPECT_EQ(timebase.toTicks(babelwires::Rational(5, 6)), 10);
+
+    EXPECT_EQ(timebase.toModelDuration(0), 0);
+    EXPECT_EQ(timebase.toModelDuration(3), babelwires::Rational(1, 4));
+    EXPECT_EQ(timebase.toModelDuration(10), babelwires::Rational(5, 6));
+    EXPECT_EQ(timebase.toModelDuration(36), 3);
+}
+
+TEST(Timebase, extend) {
+    bw_music::Timebase timebase;
+    EXPECT_EQ(timebase.getTicksPerWholeNote(), 1);
+
+    EXPECT_EQ(timebase.extendToRepresent(3), 1);
+    EXPECT_EQ(timebase.getTicksPerWholeNote(), 1);
+
+    EXPECT_EQ(timebase.extendToRepresent(babelwires::Rational(1, 4)), 4);
+    EXPECT_EQ(timebase.getTicksPerWholeNote(), 4);
+
+    EXPECT_EQ(timebase.extendToRepresent(babelwires::Rational(1, 6)), 3);
+    EXPECT_EQ(timebase, bw_music::Timebase(12));
+
+    EXPECT_EQ(timebase.extendToRepresent(babelwires::Rational(7, 12)), 1);
+    EXPECT_EQ(timebase, bw_music::Timebase(12));
+
+    EXPECT_EQ(timebase.extendToRepresent(bw_music::Timebase(8)), 2);
+    EXPECT_EQ(timebase, bw_music::Timebase(24));
+}
+
+TEST(Timebase, trackTimebase) {
+    bw_music::Track track;
+    EXPECT_EQ(track.getTimebase(), bw_music::Timebase());
+
+    testUtils::addSimpleNotes({60, 62}, track);
+    EXPECT_EQ(track.getTimebase(), bw_music::Timebase(4));
+
+    track.addEvent(bw_music::NoteOnEvent{babelwires::Rational(1, 3), 60});
+    track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 6), 60});
+    EXPECT_EQ(track.getTimebase(), bw_music::Timebase(12));
+    EXPECT_EQ(track.getTotalEventDuration(), 1);
+    EXPECT_EQ(track.getDuration(), 1);
+    EXPECT_EQ(bw_music::getMinimumDenominator(track), 12);
+
+    // The duration need not be a multiple of a tick.
+    track.setDuration(babelwires::Rational(11, 10));
+    EXPECT_EQ(track.getDuration(), babelwires::Rational(11, 10));
+    EXPECT_EQ(track.getTimebase(), bw_music::Timebase(12));
+}
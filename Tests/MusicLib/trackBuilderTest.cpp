@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/trackEventHolder.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+TEST(TrackBuilder, empty) {
+    bw_music::TrackBuilder builder;
+    EXPECT_EQ(builder.getNumEvents(), 0);
+    EXPECT_EQ(builder.getDuration(), 0);
+
+    const bw_music::Track track = builder.finishAndGetTrack();
+    EXPECT_EQ(track.getNumEvents(), 0);
+    EXPECT_EQ(track.getDuration(), 0);
+    EXPECT_EQ(track, bw_music::Track());
+    EXPECT_EQ(track.getHash(), bw_music::Track().getHash());
+}
+
+TEST(TrackBuilder, sameAsAddingToTrack) {
+    const std::vector<bw_music::Pitch> pitches{60, 62, 64, 65};
+
+    bw_music::Track expectedTrack;
+    testUtils::addSimpleNotes(pitches, expectedTrack);
+
+    bw_music::TrackBuilder builder;
+    for (auto pitch : pitches) {
+        builder.addEvent(bw_music::NoteOnEvent{0, pitch});
+        builder.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), pitch});
+    }
+    EXPECT_EQ(builder.getNumEvents(), 8);
+    EXPECT_EQ(builder.getTotalEventDuration(), 1);
+    EXPECT_EQ(builder.getDuration(), 1);
+
+    const bw_music::Track track = builder.finishAndGetTrack();
+    testUtils::testSimpleNotes(pitches, track);
+    EXPECT_EQ(track, expectedTrack);
+    EXPECT_EQ(track.getHash(), expectedTrack.getHash());
+    EXPECT_EQ(track.getNumEventGroupsByCategory(), expectedTrack.getNumEventGroupsByCategory());
+}
+
+TEST(TrackBuilder, appendRange) {
+    bw_music::Track sourceTrack;
+    testUtils::addSimpleNotes({60, 62, 64, 65}, sourceTrack);
+
+    bw_music::TrackBuilder builder;
+    builder.appendRange(sourceTrack.begin(), sourceTrack.end());
+    builder.appendRange(sourceTrack.begin(), sourceTrack.end());
+
+    bw_music::Track expectedTrack;
+    testUtils::addSimpleNotes({60, 62, 64, 65, 60, 62, 64, 65}, expectedTrack);
+
+    const bw_music::Track track = builder.finishAndGetTrack();
+    EXPECT_EQ(track, expectedTrack);
+    EXPECT_EQ(track.getHash(), expectedTrack.getHash());
+}
+
+TEST(TrackBuilder, duration) {
+    bw_music::TrackBuilder builder;
+    builder.setDuration(2);
+    EXPECT_EQ(builder.getDuration(), 2);
+
+    builder.addEvent(bw_music::NoteOnEvent{1, 60});
+    builder.addEvent(bw_music::NoteOffEvent{1, 60});
+    EXPECT_EQ(builder.getTotalEventDuration(), 2);
+    EXPECT_EQ(builder.getDuration(), 2);
+
+    builder.addEvent(bw_music::NoteOnEvent{1, 60});
+    builder.addEvent(bw_music::NoteOffEvent{1, 60});
+    EXPECT_EQ(builder.getDuration(), 4);
+
+    // Ignored, since it is shorter than the events.
+    builder.setDuration(3);
+    EXPECT_EQ(builder.getDuration(), 4);
+
+    builder.setDuration(6);
+    EXPECT_EQ(builder.getDuration(), 6);
+
+    const bw_music::Track track = builder.finishAndGetTrack();
+    EXPECT_EQ(track.getNumEvents(), 4);
+    EXPECT_EQ(track.getTotalEventDuration(), 4);
+    EXPECT_EQ(track.getDuration(), 6);
+}
+
+TEST(TrackBuilder, passThroughSharesUnchangedEvents) {
+    // Long enough to need several segments.
+    std::vector<bw_music::Pitch> pitches;
+    for (int i = 0; i < 3000; ++i) {
+        pitches.emplace_back(40 + (i % 40));
+    }
+    bw_music::Track sourceTrack;
+    testUtils::addSimpleNotes(pitches, sourceTrack);
+
+    // Transpose one note in the middle and pass the rest through.
+    const int indexOfChangedEvent = 3000;
+    bw_music::TrackBuilder builder;
+    int index = 0;
+    for (auto it = sourceTrack.begin(); it != sourceTrack.end(); ++it, ++index) {
+        if ((index == indexOfChangedEvent) || (index == indexOfChangedEvent + 1)) {
+            bw_music::TrackEventHolder holder(*it);
+            holder->transpose(1);
+            builder.addEvent(holder.release());
+        } else {
+            builder.passThroughEvent(it);
+        }
+    }
+    EXPECT_EQ(builder.getNumEvents(), sourceTrack.getNumEvents());
+    const bw_music::Track track = builder.finishAndGetTrack();
+
+    pitches[indexOfChangedEvent / 2] += 1;
+    bw_music::Track expectedTrack;
+    testUtils::addSimpleNotes(pitches, expectedTrack);
+    EXPECT_EQ(track, expectedTrack);
+    EXPECT_EQ(track.getHash(), expectedTrack.getHash());
+    EXPECT_EQ(track.getDuration(), expectedTrack.getDuration());
+
+    // Events at the start and end are in segments which were shared, and the changed event is not.
+    EXPECT_EQ(&*track.begin(), &*sourceTrack.begin());
+    auto sourceIt = sourceTrack.begin();
+    auto it = track.begin();
+    const bw_music::TrackEvent* lastSourceEvent = nullptr;
+    const bw_music::TrackEvent* lastEvent = nullptr;
+    for (index = 0; it != track.end(); ++it, ++sourceIt, ++index) {
+        if (index == indexOfChangedEvent) {
+            EXPECT_NE(&*it, &*sourceIt);
+        }
+        lastSourceEvent = &*sourceIt;
+        lastEvent = &*it;
+    }
+    EXPECT_EQ(lastEvent, lastSourceEvent);
+}
+
+TEST(TrackBuilder, passThroughNonConsecutiveEvents) {
+    bw_music::Track sourceTrack;
+    testUtils::addSimpleNotes({60, 62, 64, 65}, sourceTrack);
+
+    // Pass through the notes in reverse order.
+    std::vector<bw_music::Track::const_iterator> iterators;
+    for (auto it = sourceTrack.begin(); it != sourceTrack.end(); ++it) {
+        iterators.emplace_back(it);
+    }
+    bw_music::TrackBuilder builder;
+    for (int i = iterators.size() - 2; i >= 0; i -= 2) {
+        builder.passThroughEvent(iterators[i]);
+        builder.passThroughEvent(iterators[i + 1]);
+    }
+
+    bw_music::Track expectedTrack;
+    testUtils::addSimpleNotes({65, 64, 62, 60}, expectedTrack);
+    EXPECT_EQ(builder.finishAndGetTrack(), expectedTrack);
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Utilities/trackDemultiplexer.hpp>
+
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+TEST(TrackDemultiplexer, routeAndDrop) {
+    bw_music::Track track;
+    testUtils::addSimpleNotes({60, 61, 62, 63, 64, 65}, track);
+
+    // Even pitches to output 1, odd pitches to output 0, except 65 which is dropped.
+    std::vector<bw_music::Track> outputs =
+        bw_music::demultiplexTrack(track, 2, [](const bw_music::TrackEvent& event) -> int {
+            const bw_music::Pitch pitch = event.as<bw_music::NoteEvent>()->m_pitch;
+            if (pitch == 65) {
+                return -1;
+            }
+            return (pitch % 2 == 0) ? 1 : 0;
+        });
+    ASSERT_EQ(outputs.size(), 2);
+
+    testUtils::testNotes({{61, babelwires::Rational(1, 4)}, {63, babelwires::Rational(1, 4)}}, outputs[0]);
+    EXPECT_EQ(outputs[0].getDuration(), babelwires::Rational(3, 2));
+    testUtils::testNotes({{60}, {62, babelwires::Rational(1, 4)}, {64, babelwires::Rational(1, 4)}}, outputs[1]);
+    EXPECT_EQ(outputs[1].getDuration(), babelwires::Rational(3, 2));
+}
+
+TEST(TrackDemultiplexer, singleOutput) {
+    bw_music::Track track;
+    testUtils::addSimpleNotes({60, 62, 64, 65}, track);
+
+    std::vector<bw_music::Track> outputs =
+        bw_music::demultiplexTrack(track, 1, [](const bw_music::TrackEvent&) { return 0; });
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs[0], track);
+}
@@ -1,10 +1,14 @@
 #include <gtest/gtest.h>
 
 #include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
 #include <MusicLib/Types/Track/track.hpp>
 
 #include <Tests/TestUtils/seqTestUtils.hpp>
 
+#include <atomic>
+#include <thread>
+
 TEST(Track, Simple) {
     bw_music::Track track;
     const size_t hashWhenEmpty = track.getHash();
@@ -153,4 +157,187 @@ TEST(Track, equality) {
     EXPECT_NE(trackWithDifferentNotes, trackWithNotes);
     EXPECT_NE(trackWithNotes, trackWithMoreNotes);
     EXPECT_NE(trackWithNotes, trackWithSameNotesLongerDuration);
-}
\ No newline at end of file
+}
+
+TEST(Track, concurrentReads) {
+    const std::vector<bw_music::Pitch> pitches{60, 62, 64, 65, 67, 69, 71, 72};
+
+    bw_music::Track referenceTrack;
+    for (int i = 0; i < 100; ++i) {
+        testUtils::addSimpleNotes(pitches, referenceTrack);
+    }
+    const std::size_t expectedHash = referenceTrack.getHash();
+    const auto expectedCategories = referenceTrack.getNumEventGroupsByCategory();
+    const bw_music::ModelDuration expectedDuration = referenceTrack.getDuration();
+
+    // Each shared track is fresh, so the threads race to compute its cached values.
+    const int numSharedTracks = 50;
+    std::vector<bw_music::Track> sharedTracks(numSharedTracks);
+    for (auto& track : sharedTracks) {
+        for (int i = 0; i < 100; ++i) {
+            testUtils::addSimpleNotes(pitches, track);
+        }
+    }
+
+    const int numThreads = 8;
+    std::atomic<int> numReadyThreads = 0;
+    std::atomic<int> numFailures = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            ++numReadyThreads;
+            while (numReadyThreads < numThreads) {
+            }
+            for (int i = 0; i < numSharedTracks; ++i) {
+                // Vary the order of the calls between threads.
+                const bw_music::Track& track = sharedTracks[(t % 2) ? i : numSharedTracks - 1 - i];
+                const bw_music::Track& neighbour = sharedTracks[(i + t) % numSharedTracks];
+                const bool isOk = (track.getNumEventGroupsByCategory() == expectedCategories) &&
+                                  (track == neighbour) && (track.getHash() == expectedHash) &&
+                                  (track.getDuration() == expectedDuration) && (track == referenceTrack);
+                if (!isOk) {
+                    ++numFailures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(numFailures, 0);
+}
+
+TEST(Track, copiesAreIndependent) {
+    // Long enough to need several segments.
+    std::vector<bw_music::Pitch> pitches(1500, 60);
+    bw_music::Track track;
+    testUtils::addSimpleNotes(pitches, track);
+
+    bw_music::Track trackCopy = track;
+    EXPECT_EQ(trackCopy, track);
+
+    track.addEvent(bw_music::NoteOnEvent{0, 72});
+    track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 72});
+    trackCopy.addEvent(bw_music::NoteOnEvent{0, 48});
+    trackCopy.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 48});
+
+    pitches.emplace_back(72);
+    testUtils::testSimpleNotes(pitches, track);
+    pitches.back() = 48;
+    testUtils::testSimpleNotes(pitches, trackCopy);
+    EXPECT_NE(trackCopy, track);
+}
+
+TEST(Track, equalityAcrossSegments) {
+    // Long enough to need several segments.
+    std::vector<bw_music::Pitch> pitches;
+    for (int i = 0; i < 1500; ++i) {
+        pitches.emplace_back(40 + (i % 40));
+    }
+    bw_music::Track track;
+    testUtils::addSimpleNotes(pitches, track);
+
+    // Shares all its segments with track.
+    const bw_music::Track trackCopy = track;
+    EXPECT_EQ(trackCopy, track);
+    EXPECT_EQ(trackCopy.getHash(), track.getHash());
+
+    // Has segments with the same hashes, but different streams.
+    bw_music::Track sameTrack;
+    testUtils::addSimpleNotes(pitches, sameTrack);
+    EXPECT_EQ(sameTrack, track);
+    EXPECT_EQ(sameTrack.getHash(), track.getHash());
+
+    // Segments are laid out differently.
+    bw_music::Track offsetTrack;
+    offsetTrack.addEvent(bw_music::NoteOnEvent{0, 40});
+    offsetTrack.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 40});
+    const bw_music::Track offsetTrackCopy = offsetTrack;
+    testUtils::addSimpleNotes(std::vector<bw_music::Pitch>(pitches.begin() + 1, pitches.end()), offsetTrack);
+    EXPECT_EQ(offsetTrack, track);
+    EXPECT_EQ(offsetTrack.getHash(), track.getHash());
+
+    pitches[1000] = 100;
+    bw_music::Track differentTrack;
+    testUtils::addSimpleNotes(pitches, differentTrack);
+    EXPECT_NE(differentTrack, track);
+    EXPECT_NE(differentTrack.getHash(), track.getHash());
+}
+
+TEST(Track, seekPositionBefore) {
+    // Long enough to need several segments. Each note lasts a quarter.
+    std::vector<bw_music::Pitch> pitches;
+    for (int i = 0; i < 3000; ++i) {
+        pitches.emplace_back(40 + (i % 40));
+    }
+    bw_music::Track track;
+    testUtils::addSimpleNotes(pitches, track);
+
+    for (int quarters = 0; quarters <= 3000; quarters += 125) {
+        const bw_music::ModelDuration time = babelwires::Rational(quarters, 4);
+        const bw_music::Track::SeekPosition seekPosition = track.getSeekPositionBefore(time);
+
+        // Compare with the state reached by a linear traversal.
+        bw_music::ModelDuration timeBeforeEvent;
+        std::set<bw_music::Track::Group> openGroups;
+        int numEventsBefore = 0;
+        for (auto it = track.begin(); it != seekPosition.m_iterator; ++it) {
+            timeBeforeEvent += it->getTimeSinceLastEvent();
+            const bw_music::TrackEvent::GroupingInfo info = it->getGroupingInfo();
+            if (info.m_grouping == bw_music::TrackEvent::GroupingInfo::Grouping::StartOfGroup) {
+                openGroups.insert({info.m_category, info.m_groupValue});
+            } else if (info.m_grouping == bw_music::TrackEvent::GroupingInfo::Grouping::EndOfGroup) {
+                openGroups.erase({info.m_category, info.m_groupValue});
+            }
+            ++numEventsBefore;
+        }
+        EXPECT_EQ(seekPosition.m_timeBeforeEvent, timeBeforeEvent);
+        EXPECT_EQ(seekPosition.m_openGroups, openGroups);
+        if (quarters > 0) {
+            EXPECT_LT(timeBeforeEvent, time);
+        }
+        // No more than one segment of events before the time should need to be visited.
+        EXPECT_LE(quarters * 2 - numEventsBefore, 1024);
+    }
+}
+
+TEST(Track, eventSummary) {
+    bw_music::Track track;
+    track.addEvent(bw_music::NoteOnEvent{0, 60});
+    track.addEvent(bw_music::PercussionOnEvent{0, "AcBass", 64});
+    track.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 60});
+    track.addEvent(bw_music::PercussionOffEvent{0, "AcBass", 64});
+    track.addEvent(bw_music::PercussionOnEvent{0, "Clap", 64});
+    track.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 4), "Clap", 64});
+
+    {
+        const bw_music::Track::EventSummary& eventSummary = track.getEventSummary();
+        EXPECT_EQ(eventSummary.m_numEventsByCategory.at(bw_music::NoteEvent::s_noteEventCategory), 2);
+        EXPECT_EQ(eventSummary.m_numEventsByCategory.at(bw_music::PercussionEvent::s_percussionEventCategory), 4);
+        EXPECT_EQ(eventSummary.m_percussionInstruments,
+                  (std::unordered_set<babelwires::ShortId>{"AcBass", "Clap"}));
+    }
+
+    // The summary is kept up-to-date once computed.
+    track.addEvent(bw_music::PercussionOnEvent{0, "LFlTom", 64});
+    track.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 4), "LFlTom", 64});
+    {
+        const bw_music::Track::EventSummary& eventSummary = track.getEventSummary();
+        EXPECT_EQ(eventSummary.m_numEventsByCategory.at(bw_music::PercussionEvent::s_percussionEventCategory), 6);
+        EXPECT_EQ(eventSummary.m_percussionInstruments,
+                  (std::unordered_set<babelwires::ShortId>{"AcBass", "Clap", "LFlTom"}));
+    }
+}
+
+TEST(Track, hashIncludesDuration) {
+    const std::vector<bw_music::Pitch> pitches{60, 62, 64, 65};
+    bw_music::Track track;
+    testUtils::addSimpleNotes(pitches, track);
+
+    bw_music::Track longerTrack;
+    testUtils::addSimpleNotes(pitches, longerTrack);
+    longerTrack.setDuration(2);
+
+    EXPECT_NE(longerTrack, track);
+    EXPECT_NE(longerTrack.getHash(), track.getHash());
+}
@@ -198,4 +198,67 @@ TEST(TransposeProcessorTest, processor) {
     EXPECT_EQ(outArray.getEntry(1).get().getDuration(), 1);
     testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{61, 63, 65, 66}, outArray.getEntry(0).get());
     testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{49, 51, 53, 54}, outArray.getEntry(1).get());
-}
\ No newline at end of file
+}
+
+TEST(TransposeProcessorTest, processorManyTracksWithExecutor) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+
+    bw_music::TransposeProcessor processor(testEnvironment.m_projectContext);
+
+    processor.getInput().setToDefault();
+    processor.getOutput().setToDefault();
+
+    babelwires::ValueTreeNode& input = processor.getInput();
+    const babelwires::ValueTreeNode& output = processor.getOutput();
+
+    babelwires::ArrayInstanceImpl<babelwires::ValueTreeNode, bw_music::TrackType> inArray(
+        input.getChildFromStep(bw_music::TransposeProcessor::getCommonArrayId()).is<babelwires::ValueTreeNode>());
+    const babelwires::ArrayInstanceImpl<const babelwires::ValueTreeNode, bw_music::TrackType> outArray(
+        output.getChildFromStep(bw_music::TransposeProcessor::getCommonArrayId()).is<babelwires::ValueTreeNode>());
+
+    bw_music::TransposeProcessorInput::Instance in(input);
+
+    constexpr int numTracks = 16;
+    inArray.setSize(numTracks);
+    for (int i = 0; i < numTracks; ++i) {
+        bw_music::Track track;
+        testUtils::addSimpleNotes(std::vector<bw_music::Pitch>{static_cast<bw_music::Pitch>(40 + i)}, track);
+        inArray.getEntry(i).set(std::move(track));
+    }
+
+    // An executor which runs the tasks in reverse, so the results must not depend on the order of execution.
+    std::size_t numTasksExecuted = 0;
+    bw_music::ParallelTrackProcessor::setExecutor(
+        [&numTasksExecuted](std::size_t numTasks, const std::function<void(std::size_t)>& task) {
+            for (std::size_t i = numTasks; i > 0; --i) {
+                task(i - 1);
+            }
+            numTasksExecuted += numTasks;
+        });
+
+    processor.process(testEnvironment.m_log);
+    EXPECT_EQ(numTasksExecuted, numTracks);
+
+    processor.getInput().clearChanges();
+    in.getOffset().set(2);
+    processor.process(testEnvironment.m_log);
+    EXPECT_EQ(numTasksExecuted, 2 * numTracks);
+
+    bw_music::ParallelTrackProcessor::setExecutor({});
+
+    ASSERT_EQ(outArray.getSize(), numTracks);
+    for (int i = 0; i < numTracks; ++i) {
+        testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{static_cast<bw_music::Pitch>(42 + i)},
+                                   outArray.getEntry(i).get());
+    }
+
+    // The default executor uses several threads.
+    processor.getInput().clearChanges();
+    in.getOffset().set(-2);
+    processor.process(testEnvironment.m_log);
+    for (int i = 0; i < numTracks; ++i) {
+        testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{static_cast<bw_music::Pitch>(38 + i)},
+                                   outArray.getEntry(i).get());
+    }
+}